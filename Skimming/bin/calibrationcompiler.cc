@@ -0,0 +1,31 @@
+#include <ChargedSkimming/Skimming/interface/jmetable.h>
+
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+//Fill binary calibration cache before running the skimmer, e.g. in a batch job setup:
+//calibrationcompiler $CMSSW_BASE/src/ChargedSkimming/Skimming/data/{JEC,JME}/*.txt
+//The cache directory is $CHARGEDSKIM_CACHE, $TMPDIR or /tmp, as for the skimmer itself
+int main(int argc, char* argv[]){
+    if(argc < 2){
+        std::cout << "Usage: " << argv[0] << " JEC/JER text files..." << std::endl;
+        return 1;
+    }
+
+    int nFailed = 0;
+
+    for(int i = 1; i < argc; i++){
+        try{
+            JMETable table(argv[i]);
+            std::cout << "Cached " << argv[i] << " (" << table.NRecords() << " records) in " << table.CacheFile() << std::endl;
+        }
+
+        catch(const std::exception &error){
+            std::cout << "Failed to cache " << argv[i] << ": " << error.what() << std::endl;
+            nFailed++;
+        }
+    }
+
+    return nFailed == 0 ? 0 : 1;
+}
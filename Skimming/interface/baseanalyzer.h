@@ -10,11 +10,18 @@
 #include <TFile.h>
 #include <TH2F.h>
 #include <Rtypes.h>
-#include <TLorentzVector.h>
 #include <TTreeReader.h>
 #include <TTreeReaderValue.h>
 #include <TTreeReaderArray.h>
 
+#include <ChargedSkimming/Skimming/interface/flatcollection.h>
+#include <ChargedSkimming/Skimming/interface/cutflow.h>
+#include <ChargedSkimming/Skimming/interface/fourvector.h>
+#include <ChargedSkimming/Skimming/interface/triggerobjectindex.h>
+#include <ChargedSkimming/Skimming/interface/genealogytable.h>
+#include <ChargedSkimming/Skimming/interface/eventcontext.h>
+#include <ChargedSkimming/Skimming/interface/inputcolumns.h>
+
 #include <FWCore/Framework/interface/Event.h>
 
 #include <DataFormats/PatCandidates/interface/Electron.h>
@@ -33,33 +40,6 @@
 #include <DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h>
 #include <FWCore/Common/interface/TriggerNames.h>
 
-//Struct for cutflow
-struct CutFlow {
-    TH1F* hist;
-    Float_t weight = 1.;
-
-    unsigned int nMinEle=0;
-    unsigned int nMinMu=0;
-    unsigned int nMinJet=0;
-    unsigned int nMinFatjet=0;
-    
-    bool passed = true;
-
-};
-
-typedef edm::EDGetTokenT<std::vector<pat::Jet>> jToken;
-typedef edm::EDGetTokenT<std::vector<reco::GenJet>> genjToken;
-typedef edm::EDGetTokenT<std::vector<pat::Electron>> eToken;
-typedef edm::EDGetTokenT<std::vector<pat::Muon>> muToken;
-typedef edm::EDGetTokenT<edm::TriggerResults> trigToken;
-typedef edm::EDGetTokenT<std::vector<PileupSummaryInfo>> puToken;
-typedef edm::EDGetTokenT<GenEventInfoProduct> genToken;
-typedef edm::EDGetTokenT<std::vector<pat::MET>> mToken;
-typedef edm::EDGetTokenT<std::vector<pat::TriggerObjectStandAlone>> trigObjToken;
-typedef edm::EDGetTokenT<std::vector<reco::GenParticle>> genPartToken;
-typedef edm::EDGetTokenT<std::vector<reco::Vertex>> vtxToken;
-typedef edm::EDGetTokenT<std::vector<reco::VertexCompositePtrCandidate>> secvtxToken;
-
 class BaseAnalyzer {
     protected:
         //File path for SF etc.
@@ -79,45 +59,83 @@ class BaseAnalyzer {
         TTreeReader* reader = NULL;
         bool isNANO;
 
-        std::unique_ptr<TTreeReaderValue<unsigned int>> run;
+        //Input branches of the reader, shared with the other analyzers so each branch is read once
+        //Only set by SetInput, a NANO analyzer never registers branches on its own
+        std::shared_ptr<InputColumns> input;
+
+        //Write NanoAOD like flat output instead of std::vector branches
+        bool flatOutput = false;
 
-        std::unique_ptr<TTreeReaderArray<float>> trigObjPt;
-        std::unique_ptr<TTreeReaderArray<float>> trigObjPhi;
-        std::unique_ptr<TTreeReaderArray<float>> trigObjEta;
-        std::unique_ptr<TTreeReaderArray<int>> trigObjID;
-        std::unique_ptr<TTreeReaderArray<int>> trigObjFilterBit;
+        //Evaluate systematic variations (e.g. JES/JER) in the same pass as nominal
+        bool systematics = false;
+
+        std::shared_ptr<InputValue<unsigned int>> run;
+
+        std::shared_ptr<InputArray<float>> trigObjPt;
+        std::shared_ptr<InputArray<float>> trigObjPhi;
+        std::shared_ptr<InputArray<float>> trigObjEta;
+        std::shared_ptr<InputArray<int>> trigObjID;
+        std::shared_ptr<InputArray<int>> trigObjFilterBit;
+
+        //Trigger objects of the current event, shared with the other analyzers
+        std::shared_ptr<TriggerObjectIndex> triggerObjects = std::make_shared<TriggerObjectIndex>();
     
-        std::unique_ptr<TTreeReaderArray<float>> genPhi;
-        std::unique_ptr<TTreeReaderArray<float>> genEta;
-        std::unique_ptr<TTreeReaderArray<float>> genPt;
-        std::unique_ptr<TTreeReaderArray<float>> genMass;
-        std::unique_ptr<TTreeReaderArray<int>> genID;
-        std::unique_ptr<TTreeReaderArray<int>> genMotherIdx;
-        std::unique_ptr<TTreeReaderArray<int>> genStatus;
-        std::unique_ptr<TTreeReaderArray<int>> eleGenIdx;
-        std::unique_ptr<TTreeReaderArray<int>> muonGenIdx;
+        std::shared_ptr<InputArray<float>> genPhi;
+        std::shared_ptr<InputArray<float>> genEta;
+        std::shared_ptr<InputArray<float>> genPt;
+        std::shared_ptr<InputArray<float>> genMass;
+        std::shared_ptr<InputArray<int>> genID;
+        std::shared_ptr<InputArray<int>> genMotherIdx;
+        std::shared_ptr<InputArray<int>> genStatus;
+        std::shared_ptr<InputArray<int>> eleGenIdx;
+        std::shared_ptr<InputArray<int>> muonGenIdx;
+
+        //Index of the cut step of this analyzer in each cutflow, registered in BeginJob
+        std::vector<unsigned int> cutSteps;
+
+        //Gen particle genealogy of the current event, shared with the other analyzers
+        std::shared_ptr<GenealogyTable> genealogy = std::make_shared<GenealogyTable>();
 
         //Set trihObj and Gen particle collection
         void SetCollection(bool &isData);
 
-        //Check for gen particle if it is last copy
-        const reco::Candidate* LastCopy(const reco::GenParticle& part, const int& pdgID);
-        const reco::Candidate* LastCopy(const reco::Candidate* part, const int& pdgID); //MINIAOD
-        int LastCopy(const int& index, const int& pdgID); //NANOAOD
+        //Genealogy of the current event, built on first use
+        const GenealogyTable& Genealogy(const std::vector<reco::GenParticle>& genParticle = {});
 
         //Match Reco to gen particles
-        bool SetGenParticles(TLorentzVector &lepton, const int &i, const int &pdgID, const std::vector<reco::GenParticle>& genParticle={});
+        bool SetGenParticles(const FourVector &lepton, const int &i, const int &pdgID, const std::vector<reco::GenParticle>& genParticle={});
 
-        //Trigger matching
-        bool triggerMatching(const TLorentzVector &particle, const std::vector<pat::TriggerObjectStandAlone> trigObj = {});
+        //Trigger matching to trigger objects of the given type
+        bool triggerMatching(const FourVector &particle, const TriggerObjectIndex::ObjectType &type, const std::vector<pat::TriggerObjectStandAlone> &trigObj = {});
 
 
     public:
         virtual ~BaseAnalyzer(){};
         BaseAnalyzer();
         BaseAnalyzer(TTreeReader* reader);
-        virtual void BeginJob(std::vector<TTree*>& trees, bool &isData) = 0;
-        virtual void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event = NULL) = 0;
+        virtual void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows) = 0;
+        virtual void Analyze(std::vector<CutFlow> &cutflows, EventContext* context = NULL) = 0;
         virtual void EndJob(TFile* file) = 0;
+
+        //Analyzer reads collections produced in front of the skimmer, not run for events failing the MiniPreSelector
+        virtual bool NeedsProducedCollections() const {return true;}
+
+        //Channels which need this analyzer, i.e. it can reject them or fills one of their cut steps
+        //If no channel still passing needs it, the skimmer may skip the analyzer and only Clear() its output
+        virtual bool IsNeeded(const CutFlow &cutflow) const {return true;}
+        virtual void Clear(){}
+
+        //Bit i set if i-th channel needs this analyzer
+        unsigned int ChannelMask(const std::vector<CutFlow> &cutflows) const;
+
+        //Has to be set before BeginJob
+        void SetFlatOutput(const bool &flatOutput);
+        void SetSystematics(const bool &systematics);
+        void SetTriggerObjects(const std::shared_ptr<TriggerObjectIndex> &triggerObjects);
+        void SetGenealogy(const std::shared_ptr<GenealogyTable> &genealogy);
+        void SetInput(const std::shared_ptr<InputColumns> &input);
+
+        //Add results of same analyzer from other skimming thread, needed for analyzers filling histograms
+        virtual void Merge(const std::shared_ptr<BaseAnalyzer>& other){};
 };
 #endif
@@ -0,0 +1,53 @@
+#ifndef BTAGSFTABLE_H
+#define BTAGSFTABLE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <CondFormats/BTauObjects/interface/BTagCalibration.h>
+#include <CondTools/BTau/interface/BTagCalibrationReader.h>
+
+//b-tag SF of several working points tabulated on a (|eta|, pt) grid, same as BTagCalibrationReader::eval_auto_bounds
+//Values are interpolated linearly between pt nodes, which are at most ptStep apart
+//Every pt bin edge of the CSV has nodes on both sides, so the interpolation never mixes two bins
+class BTagSFTable {
+    public:
+        enum Variation {CENTRAL, UP, DOWN};
+
+    private:
+        //Grid in |eta|, cells are evaluated at their centre
+        float etaMax = 2.5;
+        float etaStep = 0.1;
+        float ptStep = 1.;
+        unsigned int nEta = 0;
+        unsigned int nWP = 0;
+
+        //Valid pt range of each (working point, eta cell), no SF if ptMin >= ptMax
+        std::vector<float> ptMin;
+        std::vector<float> ptMax;
+
+        //Nodes of cell c are nodePt[offsets[c]] to nodePt[offsets[c+1]], with central, up and down value each
+        //First and last node are just outside of [ptMin, ptMax] and hold the out of bound values of eval_auto_bounds
+        std::vector<std::uint32_t> offsets;
+        std::vector<float> nodePt;
+        std::vector<float> nodeValues;
+
+        void Fill(const BTagCalibration &calib, const std::string &measurement, const std::vector<BTagEntry::OperatingPoint> &workingPoints, const BTagEntry::JetFlavor &flavor);
+
+        //Binary layout for the calibration cache
+        std::vector<char> Serialize() const;
+        bool Deserialize(const char* data, const std::size_t &size);
+
+    public:
+        BTagSFTable();
+        BTagSFTable(const std::string &csvFile, const std::string &measurement, const std::vector<BTagEntry::OperatingPoint> &workingPoints, const BTagEntry::JetFlavor &flavor = BTagEntry::FLAV_B);
+
+        //SF of one working point and variation
+        float Evaluate(const unsigned int &wp, const Variation &variation, const float &absEta, const float &pt) const;
+
+        //SF of all working points and variations for a batch of jets, values[3*wp + variation][jet]
+        void Evaluate(const std::vector<float> &absEta, const std::vector<float> &pt, std::vector<std::vector<float>> &values) const;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef CALIBRATIONCACHE_H
+#define CALIBRATIONCACHE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//Read only, memory mapped binary file of the calibration cache
+//The mapping is shared between all processes on a node reading the same cache file
+class CalibrationCache {
+    private:
+        const char* data = NULL;
+        std::size_t size = 0;
+
+    public:
+        //Increase if the binary layout or the content of cached objects changes, old cache files are then ignored
+        static const std::uint32_t version = 2;
+
+        CalibrationCache(const std::string &path);
+        ~CalibrationCache();
+
+        CalibrationCache(const CalibrationCache&) = delete;
+        CalibrationCache& operator=(const CalibrationCache&) = delete;
+
+        bool IsOpen() const;
+        const char* Data() const;
+        std::size_t Size() const;
+
+        //Directory of cache files, $CHARGEDSKIM_CACHE, $TMPDIR or /tmp
+        static std::string Directory();
+
+        //Cache file of a source file with given checksum
+        static std::string Path(const std::string &prefix, const std::uint64_t &checksum);
+
+        //64 bit FNV-1a hash of the file content
+        static std::uint64_t Checksum(const std::string &content);
+
+        //Read whole source file, throws if not readable
+        static std::string ReadFile(const std::string &fileName);
+
+        //Write to temporary file and rename, so concurrent readers never see half written files
+        static bool Write(const std::string &path, const std::vector<char> &buffer);
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef CUTFLOW_H
+#define CUTFLOW_H
+
+#include <vector>
+#include <string>
+
+#include <Rtypes.h>
+
+//Cutflow of one channel, owned by each skimming thread and merged at the end
+//Analyzers register their cut steps in BeginJob and fill them per event by index
+struct CutFlow {
+    std::string channel;
+    Float_t weight = 1.;
+
+    unsigned int nMinEle=0;
+    unsigned int nMinMu=0;
+    unsigned int nMinJet=0;
+    unsigned int nMinFatjet=0;
+    
+    //Nominal decision, only nominal passed events are counted in the cut steps
+    bool passed = true;
+
+    //Bit v set if the event passes in the v-th JES/JER variation of the JetAnalyzer (bit 0 nominal)
+    //Events passing in any variation are written, with this mask stored as "variations_<channel>"
+    UInt_t passedVariations = ~0u;
+
+    //Number of selected events
+    Long64_t nPassed = 0;
+
+    //Labels of the cut steps in order of registration with sum of weights and squared weights
+    std::vector<std::string> steps;
+    std::vector<double> sumW;
+    std::vector<double> sumW2;
+    Long64_t nEntries = 0;
+
+    //Index of the cut step, a label registered twice gets the same index
+    unsigned int AddStep(const std::string &label);
+
+    //Reject event in nominal and all variations
+    void Reject(){
+        passed = false;
+        passedVariations = 0;
+    }
+
+    //Event passes in any variation, so it is written
+    bool Keep() const {return passedVariations != 0;}
+
+    //Start next event
+    void Reset(){
+        passed = true;
+        passedVariations = ~0u;
+    }
+
+    void Fill(const unsigned int &step){
+        sumW[step] += weight;
+        sumW2[step] += weight*weight;
+        nEntries++;
+    }
+
+    //Cutflows of the given channels with their minimal number of muons, electrons, jets and fat jets
+    //Single definition of the channels for the NANO skimmer, the MiniSkimmer and the MiniPreSelector
+    static std::vector<CutFlow> Channels(const std::vector<std::string> &channels);
+
+    //Add counts of the same channel of another thread
+    void Merge(const CutFlow &other);
+
+    //Write labelled histogram "cutflow_<channel>" to the current directory
+    void Write() const;
+};
+
+#endif
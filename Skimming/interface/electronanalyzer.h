@@ -2,6 +2,7 @@
 #define ELECTRONANALYZER_H
 
 #include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/scalefactortable.h>
 
 class ElectronAnalyzer: public BaseAnalyzer {
     private:
@@ -13,44 +14,43 @@ class ElectronAnalyzer: public BaseAnalyzer {
         std::map<int, std::string> tightSFfiles;
         std::map<int, std::string> recoSFfiles;
 
-        //Hist with scale factors
-        TH2F* mediumSFhist;
-        TH2F* tightSFhist;
-        TH2F* recoSFhist;
+        //Scale factors in (eta, pt)
+        ScaleFactorTable mediumSF;
+        ScaleFactorTable tightSF;
+        ScaleFactorTable recoSF;
 
         //Kinematic cut criteria
         int era;
         float ptCut;
         float etaCut;
 
-        //EDM Token for MINIAOD analysis
-        eToken eleToken;
-        trigObjToken triggerObjToken;
-        genPartToken genParticleToken;
-
         //Vector with output varirables of the output tree
         std::vector<std::string> floatNames;
         std::vector<std::string> boolNames;
 
         std::vector<std::vector<float>> floatVariables;
         std::vector<std::vector<bool>> boolVariables;
+        FlatCollection electronCollection;
 
         //TTreeReader Values for NANO AOD analysis
-        std::unique_ptr<TTreeReaderArray<float>> elePt;
-        std::unique_ptr<TTreeReaderArray<float>> eleEta;
-        std::unique_ptr<TTreeReaderArray<float>> elePhi;
-        std::unique_ptr<TTreeReaderArray<float>> eleIso;
-        std::unique_ptr<TTreeReaderArray<int>> eleCharge;
-        std::unique_ptr<TTreeReaderArray<bool>> eleMediumMVA;
-        std::unique_ptr<TTreeReaderArray<bool>> eleTightMVA;
+        std::shared_ptr<InputArray<float>> elePt;
+        std::shared_ptr<InputArray<float>> eleEta;
+        std::shared_ptr<InputArray<float>> elePhi;
+        std::shared_ptr<InputArray<float>> eleIso;
+        std::shared_ptr<InputArray<int>> eleCharge;
+        std::shared_ptr<InputArray<bool>> eleMediumMVA;
+        std::shared_ptr<InputArray<bool>> eleTightMVA;
 
     public:
-        ElectronAnalyzer(const int &era, const float &ptCut, const float &etaCut, eToken& eleToken, trigObjToken& triggerObjToken, genPartToken& genParticleToken);
+        ElectronAnalyzer(const int &era, const float &ptCut, const float &etaCut);
         ElectronAnalyzer(const int &era, const float &ptCut, const float &etaCut, TTreeReader& reader);
 
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
         void EndJob(TFile* file);
+
+        bool IsNeeded(const CutFlow &cutflow) const {return cutflow.nMinEle != 0;}
+        void Clear();
 };
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef ETAPHIINDEX_H
+#define ETAPHIINDEX_H
+
+#include <vector>
+#include <functional>
+
+//Grid in eta-phi of one object collection of an event, used for dR matching without looping over all pairs
+class EtaPhiIndex {
+    private:
+        //Cells cover |eta| < etaMax, objects outside are put in the outermost cells
+        float cellSize;
+        float etaMax = 5.2;
+        int nEta;
+        int nPhi;
+
+        std::vector<float> etas;
+        std::vector<float> phis;
+
+        //Objects of cell c are entries[cellStart[c]] to entries[cellStart[c+1]]
+        std::vector<unsigned int> cellStart;
+        std::vector<unsigned int> entries;
+
+        int EtaCell(const float &eta) const;
+        int PhiCell(const float &phi) const;
+
+    public:
+        EtaPhiIndex(const float &cellSize = 0.4);
+
+        //Fill grid with the objects of the event
+        void Build(const std::vector<float> &eta, const std::vector<float> &phi);
+
+        //Indices of all objects with dR < radius, in ascending order
+        void Candidates(const float &eta, const float &phi, const float &radius, std::vector<unsigned int> &indices) const;
+
+        //One to one matching of other objects to the indexed ones, pairs with smallest dR are matched first
+        //matches[i] is the index of the object matched to other object i or -1, accept(i, j) can veto a pair
+        void Match(const std::vector<float> &eta, const std::vector<float> &phi, const float &radius, std::vector<int> &matches, const std::function<bool(const unsigned int&, const unsigned int&)> &accept = NULL) const;
+
+        //dR with wrap around at the +-pi seam, delta phi from FourVector::DeltaPhi
+        static float DeltaR(const float &eta1, const float &phi1, const float &eta2, const float &phi2);
+};
+
+#endif
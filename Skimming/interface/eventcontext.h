@@ -0,0 +1,125 @@
+#ifndef EVENTCONTEXT_H
+#define EVENTCONTEXT_H
+
+#include <vector>
+
+#include <FWCore/Framework/interface/Event.h>
+#include <FWCore/Common/interface/TriggerNames.h>
+
+#include <DataFormats/PatCandidates/interface/Electron.h>
+#include <DataFormats/PatCandidates/interface/Muon.h>
+#include <DataFormats/PatCandidates/interface/Tau.h>
+#include <DataFormats/PatCandidates/interface/Jet.h>
+#include <DataFormats/PatCandidates/interface/MET.h>
+#include <DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h>
+#include <DataFormats/JetReco/interface/GenJet.h>
+#include <DataFormats/Common/interface/TriggerResults.h>
+#include "DataFormats/Candidate/interface/Candidate.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include <SimDataFormats/PileupSummaryInfo/interface/PileupSummaryInfo.h>
+#include <SimDataFormats/GeneratorProducts/interface/GenEventInfoProduct.h>
+
+typedef edm::EDGetTokenT<std::vector<pat::Jet>> jToken;
+typedef edm::EDGetTokenT<std::vector<reco::GenJet>> genjToken;
+typedef edm::EDGetTokenT<std::vector<pat::Electron>> eToken;
+typedef edm::EDGetTokenT<std::vector<pat::Muon>> muToken;
+typedef edm::EDGetTokenT<std::vector<pat::Tau>> tToken;
+typedef edm::EDGetTokenT<edm::TriggerResults> trigToken;
+typedef edm::EDGetTokenT<std::vector<PileupSummaryInfo>> puToken;
+typedef edm::EDGetTokenT<GenEventInfoProduct> genToken;
+typedef edm::EDGetTokenT<std::vector<pat::MET>> mToken;
+typedef edm::EDGetTokenT<std::vector<pat::TriggerObjectStandAlone>> trigObjToken;
+typedef edm::EDGetTokenT<std::vector<reco::GenParticle>> genPartToken;
+typedef edm::EDGetTokenT<std::vector<reco::Vertex>> vtxToken;
+typedef edm::EDGetTokenT<std::vector<reco::VertexCompositePtrCandidate>> secvtxToken;
+
+//Tokens of all products read by the analyzers, declared with consumes by the MiniSkimmer
+struct EventTokens {
+    jToken jets;
+    jToken fatJets;
+    genjToken genJets;
+    genjToken genFatJets;
+    mToken MET;
+    eToken electrons;
+    muToken muons;
+    tToken taus;            //Only needed by the TauAnalyzer, not consumed by the MiniSkimmer
+    trigToken triggers;
+    trigObjToken triggerObjects;
+    puToken pileUp;
+    genToken genInfo;
+    genPartToken genParticles;
+    edm::EDGetTokenT<double> rho;
+    vtxToken vertices;
+    secvtxToken secVertices;
+};
+
+//Products of the current MINIAOD event shared by all analyzers
+//A product is read on the first request in the event, so products of rejected events are never read
+class EventContext {
+    private:
+        struct Products {
+            edm::Handle<std::vector<pat::Jet>> jets;
+            edm::Handle<std::vector<pat::Jet>> fatJets;
+            edm::Handle<std::vector<reco::GenJet>> genJets;
+            edm::Handle<std::vector<reco::GenJet>> genFatJets;
+            edm::Handle<std::vector<pat::MET>> MET;
+            edm::Handle<std::vector<pat::Electron>> electrons;
+            edm::Handle<std::vector<pat::Muon>> muons;
+            edm::Handle<std::vector<pat::Tau>> taus;
+            edm::Handle<edm::TriggerResults> triggers;
+            edm::Handle<std::vector<pat::TriggerObjectStandAlone>> triggerObjects;
+            edm::Handle<std::vector<PileupSummaryInfo>> pileUp;
+            edm::Handle<GenEventInfoProduct> genInfo;
+            edm::Handle<std::vector<reco::GenParticle>> genParticles;
+            edm::Handle<double> rho;
+            edm::Handle<std::vector<reco::Vertex>> vertices;
+            edm::Handle<std::vector<reco::VertexCompositePtrCandidate>> secVertices;
+
+            const edm::TriggerNames* triggerNames = NULL;
+        };
+
+        EventTokens tokens;
+        const edm::Event* event = NULL;
+        Products products;
+
+        template<typename T>
+        const edm::Handle<T>& Get(const edm::EDGetTokenT<T> &token, edm::Handle<T> &handle){
+            if(!handle.isValid()) event->getByToken(token, handle);
+
+            return handle;
+        }
+
+    public:
+        EventContext();
+        EventContext(const EventTokens &tokens);
+
+        //Start new event, products of the previous event are released
+        void SetEvent(const edm::Event &event);
+
+        unsigned int Run() const;
+        unsigned int LumiBlock() const;
+        unsigned long long EventNumber() const;
+
+        const edm::Handle<std::vector<pat::Jet>>& Jets(){return Get(tokens.jets, products.jets);}
+        const edm::Handle<std::vector<pat::Jet>>& FatJets(){return Get(tokens.fatJets, products.fatJets);}
+        const edm::Handle<std::vector<reco::GenJet>>& GenJets(){return Get(tokens.genJets, products.genJets);}
+        const edm::Handle<std::vector<reco::GenJet>>& GenFatJets(){return Get(tokens.genFatJets, products.genFatJets);}
+        const edm::Handle<std::vector<pat::MET>>& MET(){return Get(tokens.MET, products.MET);}
+        const edm::Handle<std::vector<pat::Electron>>& Electrons(){return Get(tokens.electrons, products.electrons);}
+        const edm::Handle<std::vector<pat::Muon>>& Muons(){return Get(tokens.muons, products.muons);}
+        const edm::Handle<std::vector<pat::Tau>>& Taus(){return Get(tokens.taus, products.taus);}
+        const edm::Handle<edm::TriggerResults>& Triggers(){return Get(tokens.triggers, products.triggers);}
+        const edm::Handle<std::vector<pat::TriggerObjectStandAlone>>& TriggerObjects(){return Get(tokens.triggerObjects, products.triggerObjects);}
+        const edm::Handle<std::vector<PileupSummaryInfo>>& PileUp(){return Get(tokens.pileUp, products.pileUp);}
+        const edm::Handle<GenEventInfoProduct>& GenInfo(){return Get(tokens.genInfo, products.genInfo);}
+        const edm::Handle<std::vector<reco::GenParticle>>& GenParticles(){return Get(tokens.genParticles, products.genParticles);}
+        const edm::Handle<double>& Rho(){return Get(tokens.rho, products.rho);}
+        const edm::Handle<std::vector<reco::Vertex>>& Vertices(){return Get(tokens.vertices, products.vertices);}
+        const edm::Handle<std::vector<reco::VertexCompositePtrCandidate>>& SecVertices(){return Get(tokens.secVertices, products.secVertices);}
+
+        //Names of the trigger results, shared by trigger and MET filter analyzer
+        const edm::TriggerNames& TriggerNames();
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef FLATCOLLECTION_H
+#define FLATCOLLECTION_H
+
+#include <vector>
+#include <string>
+
+#include <Rtypes.h>
+#include <TTree.h>
+
+//NanoAOD like output of one object collection: counter n<Name> and C-array leaves <Name>_<var>[n<Name>]
+class FlatCollection {
+    private:
+        //Name of collection, used as prefix of the branches
+        std::string name;
+
+        //Number of objects in event and size of allocated buffers
+        UInt_t nObjects = 0;
+        unsigned int capacity = 0;
+
+        //Column names, float columns listed in shortNames are written as Short_t (e.g. indices)
+        std::vector<std::string> floatNames;
+        std::vector<std::string> boolNames;
+        std::vector<bool> isShort;
+
+        //Buffers the branches point to, 8 bool columns are packed in one byte
+        std::vector<std::vector<Float_t>> floatBuffer;
+        std::vector<std::vector<Short_t>> shortBuffer;
+        std::vector<std::vector<UChar_t>> flagBuffer;
+
+        //Trees with branches of this collection, needed to reset addresses if buffers grow
+        std::vector<TTree*> trees;
+
+        std::string FlagName(const unsigned int &index);
+        void Reserve(const unsigned int &size);
+        void SetAddresses();
+
+    public:
+        FlatCollection();
+        FlatCollection(const std::string &name, const std::vector<std::string> &floatNames, const std::vector<std::string> &boolNames = {}, const std::vector<std::string> &shortNames = {});
+
+        //Create branches and aliases for bool columns in output trees
+        void Branch(std::vector<TTree*> &trees);
+
+        //Copy columns of the event, shorter columns (e.g. SF in data) are padded with -999
+        void Fill(const std::vector<std::vector<float>> &floatVariables, const std::vector<std::vector<bool>> &boolVariables = {});
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef FOURVECTOR_H
+#define FOURVECTOR_H
+
+#include <cmath>
+
+//Trivially copyable four vector used instead of TLorentzVector in the analyzers
+//Both the (pt, eta, phi, m) and (px, py, pz, E) components are stored, so no trigonometry is needed after construction
+class FourVector {
+    private:
+        float pt = 0., eta = 0., phi = 0., m = 0.;
+        float px = 0., py = 0., pz = 0., e = 0.;
+
+        constexpr FourVector(const float &pt, const float &eta, const float &phi, const float &m, const float &px, const float &py, const float &pz, const float &e):
+            pt(pt), eta(eta), phi(phi), m(m), px(px), py(py), pz(pz), e(e){}
+
+    public:
+        constexpr FourVector() = default;
+
+        static FourVector PtEtaPhiM(const float &pt, const float &eta, const float &phi, const float &m){
+            float px = pt*std::cos(phi), py = pt*std::sin(phi), pz = pt*std::sinh(eta);
+
+            return FourVector(pt, eta, phi, m, px, py, pz, std::sqrt(px*px + py*py + pz*pz + m*m));
+        }
+
+        static FourVector PxPyPzE(const float &px, const float &py, const float &pz, const float &e){
+            float pt = std::sqrt(px*px + py*py);
+            float m2 = e*e - pt*pt - pz*pz;
+
+            //Same convention as TLorentzVector for vectors along the beam axis and space like vectors
+            float eta = pt != 0 ? std::asinh(pz/pt) : (pz > 0 ? 10e10 : pz < 0 ? -10e10 : 0.);
+            float m = m2 >= 0 ? std::sqrt(m2) : -std::sqrt(-m2);
+
+            return FourVector(pt, eta, pt != 0 ? std::atan2(py, px) : 0., m, px, py, pz, e);
+        }
+
+        constexpr float Pt() const {return pt;}
+        constexpr float Eta() const {return eta;}
+        constexpr float Phi() const {return phi;}
+        constexpr float M() const {return m;}
+        constexpr float Px() const {return px;}
+        constexpr float Py() const {return py;}
+        constexpr float Pz() const {return pz;}
+        constexpr float E() const {return e;}
+
+        //Null vector, e.g. no gen match found
+        constexpr bool IsZero() const {return e == 0 and pt == 0;}
+
+        //Scaling changes momentum and mass, but not the direction
+        constexpr FourVector& operator*=(const float &scale){
+            pt *= scale; m *= scale;
+            px *= scale; py *= scale; pz *= scale; e *= scale;
+
+            return *this;
+        }
+
+        constexpr FourVector operator*(const float &scale) const {
+            return FourVector(*this) *= scale;
+        }
+
+        //Delta phi wrapped into [-pi, pi]
+        static constexpr float DeltaPhi(const float &phi1, const float &phi2){
+            float dPhi = phi1 - phi2;
+
+            while(dPhi > float(M_PI)) dPhi -= float(2*M_PI);
+            while(dPhi <= -float(M_PI)) dPhi += float(2*M_PI);
+
+            return dPhi;
+        }
+
+        constexpr float DeltaR2(const float &eta2, const float &phi2) const {
+            float dEta = eta - eta2, dPhi = DeltaPhi(phi, phi2);
+
+            return dEta*dEta + dPhi*dPhi;
+        }
+
+        float DeltaR(const float &eta2, const float &phi2) const {
+            return std::sqrt(DeltaR2(eta2, phi2));
+        }
+
+        float DeltaR(const FourVector &other) const {
+            return DeltaR(other.eta, other.phi);
+        }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef GENEALOGYTABLE_H
+#define GENEALOGYTABLE_H
+
+#include <vector>
+#include <unordered_map>
+
+#include <ChargedSkimming/Skimming/interface/inputcolumns.h>
+
+#include <DataFormats/HepMCCandidate/interface/GenParticle.h>
+
+//Mother relations of the gen particles of one event, shared by all analyzers of a skimming thread
+//Built by the first analyzer asking for it, the skimmer clears it before each event
+class GenealogyTable {
+    public:
+        //Origin of a particle from its resolved ancestor and the ancestor of that
+        enum Origin {NONE, HC_W, HC_H, H};
+
+    private:
+        bool isBuilt = false;
+
+        //Absolute pdg ID and mother index, -1 if the mother is not in the collection
+        std::vector<int> pdgIDs;
+        std::vector<int> mothers;
+
+        //First and last copy of the chain of particles with the same pdg ID the particle belongs to
+        std::vector<int> firstCopies;
+        std::vector<int> lastCopies;
+        std::vector<int> depths;
+
+        //Mother of the first copy and its absolute pdg ID, 0 if there is none
+        std::vector<int> ancestors;
+        std::vector<int> ancestorIDs;
+        std::vector<Origin> origins;
+
+        //Position of MINI gen particles in the collection
+        std::unordered_map<const reco::Candidate*, int> candidateIndex;
+
+        void Resolve();
+
+    public:
+        //Mark as outdated, done by the skimmer for each new event
+        void Clear();
+        bool IsBuilt() const;
+
+        void Build(const ColumnView<int> &pdgID, const ColumnView<int> &motherIdx); //NANOAOD
+        void Build(const std::vector<reco::GenParticle> &genParticles); //MINIAOD
+
+        unsigned int Size() const;
+        int PdgID(const int &i) const;
+        int FirstCopy(const int &i) const;
+        int LastCopy(const int &i) const;
+        int Ancestor(const int &i) const;
+        int AncestorID(const int &i) const;
+        Origin GetOrigin(const int &i) const;
+
+        //Index of a MINI gen particle in the collection, -1 if not found
+        int Index(const reco::Candidate* candidate) const;
+};
+
+#endif
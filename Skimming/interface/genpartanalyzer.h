@@ -8,20 +8,21 @@ class GenPartAnalyzer: public BaseAnalyzer{
         //Bool for checking if data file
         bool isData;
 
-        //EMD Token for MINIAOD
-        genPartToken genParticleToken;
-
         //Set output names
         std::vector<std::string> floatNames;
         std::vector<std::vector<float>> leptonVariables;
         std::vector<std::vector<float>> h1Variables;
         std::vector<std::vector<float>> h2Variables;
 
+        FlatCollection leptonCollection;
+        FlatCollection h1Collection;
+        FlatCollection h2Collection;
+
     public:
-        GenPartAnalyzer(genPartToken& genParticleToken);
+        GenPartAnalyzer();
         GenPartAnalyzer(TTreeReader &reader);
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
         void EndJob(TFile* file);
 };
 
@@ -0,0 +1,130 @@
+#ifndef INPUTCOLUMNS_H
+#define INPUTCOLUMNS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <stdexcept>
+
+#include <TTreeReader.h>
+#include <TTreeReaderValue.h>
+#include <TTreeReaderArray.h>
+
+//Span like view of one array branch of the current entry
+template<typename T>
+struct ColumnView {
+    const T* data = NULL;
+    std::size_t size = 0;
+
+    const T& operator[](const std::size_t &i) const {return data[i];}
+    const T& At(const std::size_t &i) const {return data[i];}
+    std::size_t GetSize() const {return size;}
+
+    const T* begin() const {return data;}
+    const T* end() const {return data + size;}
+};
+
+//Array branch read once per entry, elements are accessed through a plain pointer instead of the TTreeReaderArray proxy
+template<typename T>
+class InputArray {
+    private:
+        TTreeReader& reader;
+        TTreeReaderArray<T> array;
+
+        //Entry the view belongs to
+        Long64_t entry = -1;
+        ColumnView<T> view;
+
+        //Only used if the branch buffer is not contiguous
+        std::unique_ptr<T[]> buffer;
+        std::size_t capacity = 0;
+
+        void Load(){
+            entry = reader.GetCurrentEntry();
+            view.size = array.GetSize();
+
+            if(view.size == 0){
+                view.data = NULL;
+                return;
+            }
+
+            //NanoAOD leaf list arrays are contiguous in the branch buffer, so no copy is needed
+            if(view.size == 1 or &array.At(1) == &array.At(0) + 1){
+                view.data = &array.At(0);
+                return;
+            }
+
+            if(capacity < view.size){
+                capacity = view.size;
+                buffer.reset(new T[capacity]);
+            }
+
+            for(std::size_t i = 0; i < view.size; i++) buffer[i] = array.At(i);
+            view.data = buffer.get();
+        }
+
+    public:
+        InputArray(TTreeReader &reader, const std::string &name): reader(reader), array(reader, name.c_str()){}
+
+        //View of the current entry, valid until the reader moves to another entry
+        const ColumnView<T>& View(){
+            if(entry != reader.GetCurrentEntry()) Load();
+            return view;
+        }
+
+        std::size_t GetSize(){return View().size;}
+        const T& At(const std::size_t &i){return View().data[i];}
+};
+
+//Single value branch, same interface as TTreeReaderValue
+template<typename T>
+class InputValue {
+    private:
+        TTreeReaderValue<T> value;
+
+    public:
+        InputValue(TTreeReader &reader, const std::string &name): value(reader, name.c_str()){}
+
+        T* Get(){return value.Get();}
+};
+
+//Registry of the input branches of one TTreeReader, shared by all analyzers of a skimming thread
+//Each branch is registered once, analyzers asking for the same branch get the same column
+class InputColumns {
+    private:
+        TTreeReader& reader;
+        std::map<std::string, std::pair<std::type_index, std::shared_ptr<void>>> columns;
+
+        template<typename C>
+        std::shared_ptr<C> Register(const std::string &name){
+            auto it = columns.find(name);
+
+            if(it == columns.end()){
+                std::shared_ptr<C> column = std::make_shared<C>(reader, name);
+                columns.emplace(name, std::make_pair(std::type_index(typeid(C)), column));
+
+                return column;
+            }
+
+            if(it->second.first != std::type_index(typeid(C))){
+                throw std::runtime_error("Input branch registered with different type: " + name);
+            }
+
+            return std::static_pointer_cast<C>(it->second.second);
+        }
+
+    public:
+        InputColumns(TTreeReader &reader): reader(reader){}
+
+        template<typename T>
+        std::shared_ptr<InputArray<T>> Array(const std::string &name){return Register<InputArray<T>>(name);}
+
+        template<typename T>
+        std::shared_ptr<InputValue<T>> Value(const std::string &name){return Register<InputValue<T>>(name);}
+
+        //Number of registered branches
+        std::size_t Size() const {return columns.size();}
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef JECENGINE_H
+#define JECENGINE_H
+
+#include <ChargedSkimming/Skimming/interface/jmetable.h>
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include <CondFormats/JetMETObjects/interface/JetCorrectorParameters.h>
+#include <CondFormats/JetMETObjects/interface/FactorizedJetCorrector.h>
+
+//Factorized JEC evaluated from flat tables, same results as FactorizedJetCorrector
+class JECEngine {
+    private:
+        //Jet variables which can be used by a correction level
+        enum Variable {ETA, PT, RHO, AREA};
+
+        //Tables of the correction levels in order of application
+        std::vector<std::string> fileNames;
+        std::vector<JMETable> levels;
+
+        //Jet variable used for each bin/formula variable of each level
+        std::vector<std::vector<int>> binIndices;
+        std::vector<std::vector<int>> parIndices;
+
+        //Used instead of tables if files are not supported or validation failed
+        std::shared_ptr<FactorizedJetCorrector> fallback;
+
+        void SetFallback();
+
+        //Largest relative deviation from FactorizedJetCorrector on a grid of jets
+        float Compare() const;
+
+    public:
+        JECEngine();
+        JECEngine(const std::vector<std::string> &fileNames);
+
+        //Correction factor for one jet
+        float GetCorrection(const float &pt, const float &eta, const float &rho, const float &area) const;
+
+        //Correction factors for all jets of an event, levels are applied one after another on all jets
+        void GetCorrections(const std::vector<float> &pt, const std::vector<float> &eta, const float &rho, const std::vector<float> &area, std::vector<float> &corrections) const;
+
+        //Compare with FactorizedJetCorrector on a grid of jets, returns largest relative deviation
+        //The result is kept in the calibration cache, so the comparison only runs once per set of files
+        //If it is larger than the tolerance, the engine evaluates with FactorizedJetCorrector from then on
+        float Validate(const float &tolerance = 1e-5);
+};
+
+#endif
@@ -2,11 +2,11 @@
 #define JETANALYZER_H
 
 #include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/jecengine.h>
+#include <ChargedSkimming/Skimming/interface/philox.h>
+#include <ChargedSkimming/Skimming/interface/etaphiindex.h>
+#include <ChargedSkimming/Skimming/interface/btagsftable.h>
 
-#include <random>
-
-#include <CondFormats/BTauObjects/interface/BTagCalibration.h>
-#include <CondTools/BTau/interface/BTagCalibrationReader.h>
 #include <JetMETCorrections/Modules/interface/JetResolution.h>
 #include <JetMETCorrections/Modules/interface/JetCorrectionProducer.h>
 #include <CondFormats/JetMETObjects/interface/JetCorrectorParameters.h>
@@ -14,6 +14,7 @@
 
 class JetAnalyzer: public BaseAnalyzer{
     enum JetType {AK4, AK8};
+    enum Systematic {NOMINAL, JESUP, JESDOWN, JERUP, JERDOWN};
 
     private:
         //Bool for checking if data file
@@ -25,15 +26,16 @@ class JetAnalyzer: public BaseAnalyzer{
         std::map<JetType, std::map<int, std::string>> bTagSF;
         std::map<JetType, std::map<int, std::string>> JMESF;
         std::map<JetType, std::map<int, std::string>> JMEPtReso;
+        std::map<JetType, std::map<int, std::string>> JECUnc;
 
         //Values for bTag cuts
         std::map<JetType, std::map<int, std::vector<float>>> bTagCuts; 
 
-        //Classes for reading btag SF
-        std::map<JetType, BTagCalibration> calib;
-        std::map<JetType, BTagCalibrationReader> looseReader;
-        std::map<JetType, BTagCalibrationReader> mediumReader;
-        std::map<JetType, BTagCalibrationReader> tightReader;
+        //Tabulated btag SF of all working points, evaluated for all selected jets at once
+        std::map<JetType, BTagSFTable> bTagTable;
+        std::map<JetType, std::vector<int>> bTagColumns;
+        std::map<JetType, std::vector<float>> bTagEta, bTagPt;
+        std::vector<std::vector<float>> bTagValues;
 
         //Classes for reading jet energy SF 
         JME::JetParameters jetParameter;
@@ -45,47 +47,42 @@ class JetAnalyzer: public BaseAnalyzer{
         float ptCut;
         float etaCut;
 
-        //EDM Token for MINIAOD analysis
-        std::vector<jToken> jetTokens;
-        std::vector<genjToken> genjetTokens;
-        mToken metToken;
-        edm::EDGetTokenT<double> rhoToken;
-        genPartToken genParticleToken;
-        secvtxToken vertexToken;
 
         //TTreeReader Values for NANO AOD analysis
-        std::unique_ptr<TTreeReaderArray<float>> fatJetPt;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetEta;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetPhi;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetMass;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetArea;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetCSV;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetTau1;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetTau2;
-        std::unique_ptr<TTreeReaderArray<float>> fatJetTau3;
-
-        std::unique_ptr<TTreeReaderArray<float>> jetPt;
-        std::unique_ptr<TTreeReaderArray<float>> jetEta;
-        std::unique_ptr<TTreeReaderArray<float>> jetPhi;
-        std::unique_ptr<TTreeReaderArray<float>> jetMass;
-        std::unique_ptr<TTreeReaderArray<float>> jetArea;
-        std::unique_ptr<TTreeReaderArray<int>> jetGenIdx;
-        std::unique_ptr<TTreeReaderValue<float>> jetRho;
-        std::unique_ptr<TTreeReaderArray<float>> jetDeepBValue;
-        std::unique_ptr<TTreeReaderValue<float>> valueHT;
-
-        std::unique_ptr<TTreeReaderArray<float>> genJetPt;
-        std::unique_ptr<TTreeReaderArray<float>> genJetEta;
-        std::unique_ptr<TTreeReaderArray<float>> genJetPhi;
-        std::unique_ptr<TTreeReaderArray<float>> genJetMass;
-
-        std::unique_ptr<TTreeReaderArray<float>> genFatJetPt;
-        std::unique_ptr<TTreeReaderArray<float>> genFatJetEta;
-        std::unique_ptr<TTreeReaderArray<float>> genFatJetPhi;
-        std::unique_ptr<TTreeReaderArray<float>> genFatJetMass;
-
-        std::unique_ptr<TTreeReaderValue<float>> metPhi;
-        std::unique_ptr<TTreeReaderValue<float>> metPt;
+        std::shared_ptr<InputArray<float>> fatJetPt;
+        std::shared_ptr<InputArray<float>> fatJetEta;
+        std::shared_ptr<InputArray<float>> fatJetPhi;
+        std::shared_ptr<InputArray<float>> fatJetMass;
+        std::shared_ptr<InputArray<float>> fatJetArea;
+        std::shared_ptr<InputArray<float>> fatJetCSV;
+        std::shared_ptr<InputArray<float>> fatJetTau1;
+        std::shared_ptr<InputArray<float>> fatJetTau2;
+        std::shared_ptr<InputArray<float>> fatJetTau3;
+
+        std::shared_ptr<InputArray<float>> jetPt;
+        std::shared_ptr<InputArray<float>> jetEta;
+        std::shared_ptr<InputArray<float>> jetPhi;
+        std::shared_ptr<InputArray<float>> jetMass;
+        std::shared_ptr<InputArray<float>> jetArea;
+        std::shared_ptr<InputArray<int>> jetGenIdx;
+        std::shared_ptr<InputValue<float>> jetRho;
+        std::shared_ptr<InputArray<float>> jetDeepBValue;
+        std::shared_ptr<InputValue<float>> valueHT;
+        std::shared_ptr<InputValue<UInt_t>> lumiBlock;
+        std::shared_ptr<InputValue<ULong64_t>> evtNumber;
+
+        std::shared_ptr<InputArray<float>> genJetPt;
+        std::shared_ptr<InputArray<float>> genJetEta;
+        std::shared_ptr<InputArray<float>> genJetPhi;
+        std::shared_ptr<InputArray<float>> genJetMass;
+
+        std::shared_ptr<InputArray<float>> genFatJetPt;
+        std::shared_ptr<InputArray<float>> genFatJetEta;
+        std::shared_ptr<InputArray<float>> genFatJetPhi;
+        std::shared_ptr<InputArray<float>> genFatJetMass;
+
+        std::shared_ptr<InputValue<float>> metPhi;
+        std::shared_ptr<InputValue<float>> metPt;
 
         //Parameter for HT
         float HT;
@@ -107,24 +104,70 @@ class JetAnalyzer: public BaseAnalyzer{
         std::vector<std::vector<bool>> JetboolVariables;
         std::vector<std::vector<bool>> FatJetboolVariables;
 
-        //Get jet energy correction
-        std::map<JetType, FactorizedJetCorrector*> jetCorrector;
-        void SetCorrector(const JetType &type, const int& runNumber);
-        float CorrectEnergy(const TLorentzVector &jet, const float &rho, const float &area, const JetType &type);
+        FlatCollection jetCollection;
+        FlatCollection fatJetCollection;
+        FlatCollection jetParticleCollection;
+        FlatCollection vertexCollection;
+
+        //Get jet energy correction, evaluated for all jets of the event at once
+        std::map<JetType, std::shared_ptr<JECEngine>> jetCorrector;
+        std::map<JetType, std::vector<float>> corrFactors;
+        std::vector<float> rawPt, rawEta, rawPhi, rawArea;
+
+        //Corrector of each era is created once and kept, active one is switched if run changes
+        std::map<std::pair<JetType, std::string>, std::shared_ptr<JECEngine>> correctorCache;
+        int correctorRun = -1;
+
+        //Run ranges of the eras sorted by first run for binary search
+        std::vector<int> eraFirstRun;
+        std::vector<std::string> eraNames;
+
+        std::string GetEra(const int &runNumber);
+        void SetCorrector(const JetType &type, const std::string &eraName);
+
+        //Gaussian numbers for stochastic smearing of each jet, reproducible from (run, lumi, event, jet index)
+        std::map<JetType, std::vector<float>> gausDraws;
+
+        //Gen jets of the event in eta-phi grid and index of gen jet matched to each reco jet, -1 if none
+        std::map<JetType, std::vector<FourVector>> genJetVectors;
+        std::map<JetType, EtaPhiIndex> genJetIndex;
+        std::map<JetType, std::vector<int>> genMatch;
+        void MatchGenJets(const JetType &type, const float &rho, const std::vector<reco::GenJet> &genJets = {});
 
         //Get JER smear factor
-        float SmearEnergy(const TLorentzVector &jet, const float &rho, const float &coneSize, const JetType &type, const std::vector<reco::GenJet> &genJets = {});
+        float SmearEnergy(const FourVector &jet, const float &rho, const JetType &type, const float &gausDraw, const int &genIdx, const JME::Variation &variation = JME::NOMINAL);
+
+        //Systematic variations, evaluated in the same pass as nominal if systematics are enabled (MC only)
+        //Each variation scales the nominal four momentum of a jet with a factor
+        unsigned int nVariations = 1;
+        std::vector<std::string> variationNames = {"", "JESUp", "JESDown", "JERUp", "JERDown"};
+        std::map<JetType, JMETable> jesUncertainty;
+        std::map<JetType, unsigned int> variationColumn;
+        std::vector<float> variationFactors;
+
+        //MET and HT of each variation, index 0 is unused (nominal are metPx, metPy and HT)
+        std::vector<float> metPxVariation;
+        std::vector<float> metPyVariation;
+        std::vector<float> HTVariation;
+
+        void SetVariationFactors(const JetType &type, const FourVector &jet, const float &rho, const unsigned int &i, const float &smearFac);
+
+        //First copies of partons of the event in eta-phi grid (NANO index or MINI candidate)
+        EtaPhiIndex partonIndex;
+        std::vector<int> partonIndices;
+        std::vector<unsigned int> partonCands;
+        void SetPartons(const int &pdgID, const std::vector<reco::GenParticle>& genParticle = {});
 
         //Set Gen particle information
-        std::map<JetType, TLorentzVector> genJet; 
-        int SetGenParticles(TLorentzVector& validJet, const int &i, const int &pdgID, const JetType &type, const std::vector<reco::GenParticle>& genParticle={});
+        std::map<JetType, FourVector> genJet; 
+        int SetGenParticles(FourVector& validJet, const int &i, const JetType &type);
 
     public:
         JetAnalyzer(const int &era, const float &ptCut, const float &etaCut, TTreeReader& reader);
-        JetAnalyzer(const int &era, const float &ptCut, const float &etaCut, std::vector<jToken>& jetTokens, std::vector<genjToken>& genjetTokens, mToken &metToken, edm::EDGetTokenT<double> &rhoToken, genPartToken& genParticleToken, secvtxToken& vertexToken);
+        JetAnalyzer(const int &era, const float &ptCut, const float &etaCut);
 
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
         void EndJob(TFile* file);
 };
 
@@ -0,0 +1,99 @@
+#ifndef JMETABLE_H
+#define JMETABLE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include <TFormula.h>
+
+//Flat in memory version of a JEC/JER text file (JetCorrectorParameters format)
+//Parsed tables are kept in a binary cache next to other calibrations, see CalibrationCache
+class JMETable {
+    public:
+        //Formulas of the Fall17 files are evaluated with compiled kernels, anything else with TFormula
+        enum Kernel {CONSTANT, L1FASTJET, POLYNOMIAL, RESIDUAL, RESOLUTION, PARAMETERS, FORMULA};
+
+    private:
+        //Layout of cached table: header, header strings, double arrays, index arrays
+        struct CacheHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t nBin;
+            std::uint32_t nPar;
+            std::uint32_t hasRange;
+            std::uint64_t checksum;
+            std::uint64_t nRecords;
+            std::uint64_t nParams;
+            std::uint64_t nGroups;
+            std::uint64_t textSize;
+        };
+
+        //Header information
+        std::vector<std::string> binVariables;
+        std::vector<std::string> parVariables;
+        std::string formulaString;
+        std::string type;
+
+        //Memory with the arrays, either the mapped cache file or a buffer owned by the table
+        std::shared_ptr<const void> storage;
+        std::uint64_t checksum = 0;
+        unsigned int nRecords = 0;
+
+        //Bin edges [record*nBinVar + var], formula variable range [record*nParVar + var] (NULL if not given)
+        const double* binMin = NULL;
+        const double* binMax = NULL;
+        const double* parMin = NULL;
+        const double* parMax = NULL;
+
+        //Parameters of each record are at params[offsets[record]] to params[offsets[record+1]]
+        const double* params = NULL;
+        const std::uint32_t* offsets = NULL;
+
+        //Records with same range in first bin variable are grouped for faster search
+        const double* groupMin = NULL;
+        const std::uint32_t* groupStart = NULL;
+        unsigned int nGroups = 0;
+
+        Kernel kernel = CONSTANT;
+        double offsetX = 0.;
+        double scaleY = 1.;
+        std::shared_ptr<TFormula> formula;
+
+        //Parse text file into the binary layout of the cache
+        static std::vector<char> Parse(const std::string &content, const std::uint64_t &checksum);
+
+        //Point arrays to binary layout, false if it does not belong to the source file
+        bool Attach(const char* data, const std::size_t &size, const std::uint64_t &checksum);
+
+        void SetKernel();
+
+    public:
+        JMETable();
+        JMETable(const std::string &fileName);
+
+        //Binary cache file used for this table
+        std::string CacheFile() const;
+
+        unsigned int NRecords() const;
+        const std::vector<std::string>& BinVariables() const;
+        const std::vector<std::string>& ParVariables() const;
+        const std::string& Type() const;
+        Kernel GetKernel() const;
+
+        //Record of bin values, -1 if outside of all bins
+        int FindBin(const double* binValues) const;
+
+        //Parameters of a record, without the formula variable ranges
+        const double* Parameters(const int &record) const;
+        unsigned int NParameters(const int &record) const;
+
+        //Evaluate formula of a record, formula variables are clamped to their range
+        double Evaluate(const int &record, const double* parValues) const;
+
+        //Uncertainty tables: linear interpolation of (x, up, down) triplets, constant outside of the x range
+        double Uncertainty(const int &record, const double &x, const bool &up) const;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define METFILTERANALYZER_H
 
 #include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/triggerpathindex.h>
 
 #include <numeric>
 
@@ -13,17 +14,18 @@ class MetFilterAnalyzer : public BaseAnalyzer {
         //Map with TTreeReaderValues for each era
         std::map<int, std::vector<std::string>> filterNames;
 
-        //EDM Token for MINIAOD analysis
-        trigToken triggerToken;
+        //Position of the filters in the trigger results with MINIAOD
+        TriggerPathIndex filterIndex;
 
         //Vector with TTreeReaderValues
-        std::vector<std::unique_ptr<TTreeReaderValue<bool>>> filterValues;
+        std::vector<std::shared_ptr<InputValue<bool>>> filterValues;
 
     public:
         MetFilterAnalyzer(const int &era, TTreeReader &reader);
-        MetFilterAnalyzer(const int &era, trigToken& triggerToken);
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        MetFilterAnalyzer(const int &era);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
+        bool NeedsProducedCollections() const {return false;}
         void EndJob(TFile* file);
 };
 
@@ -0,0 +1,59 @@
+#ifndef MINIPRESELECTOR_H
+#define MINIPRESELECTOR_H
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDFilter.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+
+#include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/triggeranalyzer.h>
+#include <ChargedSkimming/Skimming/interface/metfilteranalyzer.h>
+#include <ChargedSkimming/Skimming/interface/preselectionanalyzer.h>
+
+//Analyzers of one edm stream used for the preselection
+struct PreselectionStream {
+    //Products of the current event, the object collections are the ones of the input file
+    EventContext context;
+
+    std::vector<std::shared_ptr<BaseAnalyzer>> analyzers;
+    std::vector<CutFlow> cutflows;
+};
+
+//Cheap preselection at the head of the path, so jet and egamma producers only run for events which can pass a channel
+//Uses the same trigger/MET filter analyzers as the MiniSkimmer and raw object multiplicities, accepted events are a superset of the skimmed ones
+class MiniPreSelector : public edm::global::EDFilter<edm::StreamCache<PreselectionStream>> {
+    public:
+        explicit MiniPreSelector(const edm::ParameterSet&);
+
+    private:
+        //Stream set up is serialized, the analyzers read files in BeginJob
+        mutable std::mutex streamMutex;
+
+        //Number of filtered and accepted events of all streams, stream caches are already deleted in endJob
+        mutable std::atomic<long long> nEvents{0};
+        mutable std::atomic<long long> nAccepted{0};
+
+        EventTokens tokens;
+
+        std::vector<std::string> channels;
+        std::vector<std::string> muTriggers;
+        std::vector<std::string> eleTriggers;
+        bool isData;
+
+        virtual std::unique_ptr<PreselectionStream> beginStream(edm::StreamID) const override;
+        virtual bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+        virtual void endJob() override;
+};
+
+#endif
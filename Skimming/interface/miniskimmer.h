@@ -5,13 +5,15 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <mutex>
 
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/StreamID.h"
 
 #include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
 #include <ChargedSkimming/Skimming/interface/jetanalyzer.h>
@@ -21,12 +23,47 @@
 #include <ChargedSkimming/Skimming/interface/metfilteranalyzer.h>
 #include <ChargedSkimming/Skimming/interface/weightanalyzer.h>
 #include <ChargedSkimming/Skimming/interface/genpartanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/performancemonitor.h>
 
 #include <TFile.h>
 #include <TTree.h>
 #include <TH1F.h>
 
-class MiniSkimmer : public edm::one::EDAnalyzer<edm::one::SharedResources>  {
+//Analyzers and output of one edm stream, so streams can skim events concurrently
+struct SkimStream {
+    //Output file the trees are attached to, only the first stream writes to the final file
+    TFile* outputFile;
+    std::string outputName;
+
+    //Vector with wished analyzers
+    std::vector<std::shared_ptr<BaseAnalyzer>> analyzers;
+
+    //Vector of trees and cutflow histograms for each analysis
+    std::vector<TTree*> outputTrees;
+    std::vector<CutFlow> cutflows; 
+
+    //Bit i set if i-th channel needs the analyzer, for each analyzer
+    std::vector<unsigned int> channelMasks;
+
+    //Products of the current event, each read once and shared by all analyzers
+    EventContext context;
+
+    //Trigger objects and gen particle genealogy of the current event, shared by all analyzers
+    std::shared_ptr<TriggerObjectIndex> triggerObjects = std::make_shared<TriggerObjectIndex>();
+    std::shared_ptr<GenealogyTable> genealogy = std::make_shared<GenealogyTable>();
+
+    //Bit i set if event passed i-th channel, only used with single output tree
+    UChar_t channelMask = 0;
+
+    //Timing of analyzers and fill of this stream
+    PerformanceMonitor monitor;
+
+    //Number of analyzed events
+    int nEvents=0;
+};
+
+//The framework deletes stream caches at endStream before endJob, so the cache shares ownership of the stream with the module
+class MiniSkimmer : public edm::global::EDAnalyzer<edm::StreamCache<std::shared_ptr<SkimStream>>>  {
     public:
         explicit MiniSkimmer(const edm::ParameterSet&);
         ~MiniSkimmer();
@@ -36,44 +73,47 @@ class MiniSkimmer : public edm::one::EDAnalyzer<edm::one::SharedResources>  {
         std::chrono::steady_clock::time_point start;
         std::chrono::steady_clock::time_point end;
 
-        //Output file
-        TFile* outputFile;
-        std::vector<TTree*> outputTrees;
-        std::vector<CutFlow> cutflows; 
-
-        //Vector with wished analyzers
-        std::vector<std::shared_ptr<BaseAnalyzer>> analyzers;
-
-        //EDM tokens
-        jToken jetToken; 
-        jToken fatjetToken; 
-        genjToken genjetToken; 
-        genjToken genfatjetToken; 
-        mToken metToken; 
-        eToken eleToken; 
-        muToken muonToken;
-        trigToken triggerToken; 
-        trigObjToken triggerObjToken;
-        puToken pileupToken;
-        genToken geninfoToken;
-        genPartToken genParticleToken;
-        edm::EDGetTokenT<double> rhoToken;
-        vtxToken vertexToken;
-        secvtxToken secVertexToken;
-
-        //Channel
+        //Streams kept alive after their caches are deleted, for merging in endJob
+        mutable std::vector<std::shared_ptr<SkimStream>> streams;
+        mutable std::mutex streamMutex;
+
+        //EDM tokens of all products used by the analyzers
+        EventTokens tokens;
+
+        //Decision of the MiniPreSelector, if it runs in front of the producers of the skimmed collections
+        bool hasPreselection;
+        edm::EDGetTokenT<bool> preselectionToken;
+
+        //Channel and trigger paths
         std::vector<std::string> channels;
+        std::vector<std::string> muTriggers;
+        std::vector<std::string> eleTriggers;
         float xSec;
         std::string outFile;
         bool isData;           
 
-        std::map<std::string, std::vector<unsigned int>> nMin;
+        //Output tree settings, negative values for flush/save are in bytes, memory budget per stream in MB
+        long long autoFlush;
+        long long autoSave;
+        int maxMemory;
+
+        //Write all channels in one tree "Events" with channel bitmask instead of one tree per channel
+        bool singleTree;
+
+        //Write NanoAOD like counter and C-array branches instead of std::vector branches
+        bool flatOutput;
+
+        //Write systematic variations of the objects next to nominal
+        bool systematics;
+
+        //Print timing summary and write JSON report next to the output file
+        bool performanceReport;
 
-        //Number of analyzed events
-        int nEvents=0;
+        //Skip analyzers which no channel still passing needs, e.g. electrons if only muon channels are left
+        bool skipAnalyzers;
 
-        virtual void beginJob() override;
-        virtual void analyze(const edm::Event&, const edm::EventSetup&) override;
+        virtual std::unique_ptr<std::shared_ptr<SkimStream>> beginStream(edm::StreamID) const override;
+        virtual void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
         virtual void endJob() override;
 };
 
@@ -2,6 +2,7 @@
 #define MUONANALYZER_H
 
 #include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/scalefactortable.h>
 #include <DataFormats/PatCandidates/interface/Muon.h>
 
 class MuonAnalyzer: public BaseAnalyzer{
@@ -14,11 +15,11 @@ class MuonAnalyzer: public BaseAnalyzer{
         std::map<int, std::string> triggerSFfiles;
         std::map<int, std::string> IDSFfiles;
 
-        //Hist with scale factors
-        TH2F* triggerSFhist;
+        //Scale factors in (pt, |eta|), loose and tight working point for iso and ID
+        ScaleFactorTable triggerSF;
 
-        std::vector<TH2F*> IsoHist;
-        std::vector<TH2F*> IDHist;
+        std::vector<ScaleFactorTable> isoSF;
+        std::vector<ScaleFactorTable> IDSF;
 
         //Kinematic cut criteria
         int era;
@@ -31,29 +32,27 @@ class MuonAnalyzer: public BaseAnalyzer{
 
         std::vector<std::vector<float>> floatVariables;
         std::vector<std::vector<bool>> boolVariables;
-
-        //EDM Token for MINIAOD analysis
-        muToken muonToken;
-        trigObjToken triggerObjToken; 
-        genPartToken genParticleToken;
+        FlatCollection muonCollection;
 
         //TTreeReader Values for NANO AOD analysis
-        std::unique_ptr<TTreeReaderArray<float>> muonPt;
-        std::unique_ptr<TTreeReaderArray<float>> muonEta;
-        std::unique_ptr<TTreeReaderArray<float>> muonPhi;
-        std::unique_ptr<TTreeReaderArray<float>> muonIso;
-        std::unique_ptr<TTreeReaderArray<int>> muonCharge;
-        std::unique_ptr<TTreeReaderArray<bool>> muonLooseID;
-        std::unique_ptr<TTreeReaderArray<bool>> muonTightID;
-        std::unique_ptr<TTreeReaderArray<int>> muonGenIdx;
+        std::shared_ptr<InputArray<float>> muonPt;
+        std::shared_ptr<InputArray<float>> muonEta;
+        std::shared_ptr<InputArray<float>> muonPhi;
+        std::shared_ptr<InputArray<float>> muonIso;
+        std::shared_ptr<InputArray<int>> muonCharge;
+        std::shared_ptr<InputArray<bool>> muonLooseID;
+        std::shared_ptr<InputArray<bool>> muonTightID;
 
     public:
         MuonAnalyzer(const int &era, const float &ptCut, const float &etaCut, TTreeReader& reader);
-        MuonAnalyzer(const int &era, const float &ptCut, const float &etaCut, muToken &muonToken, trigObjToken& triggerObjToken, genPartToken& genParticleToken);
+        MuonAnalyzer(const int &era, const float &ptCut, const float &etaCut);
 
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
         void EndJob(TFile* file);
+
+        bool IsNeeded(const CutFlow &cutflow) const {return cutflow.nMinMu != 0;}
+        void Clear();
 };
 
 #endif
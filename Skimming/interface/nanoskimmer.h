@@ -1,43 +1,120 @@
 #include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/performancemonitor.h>
 
 #include <vector>
 #include <string>
 #include <chrono>
 #include <memory>
+#include <atomic>
+#include <mutex>
 
 #include <TFile.h>
 #include <TTree.h>
 #include <TTreeReader.h>
 
+//Everything one thread needs to skim its own entry range of the input
+struct SkimWorker {
+    TFile* inputFile;
+    std::unique_ptr<TTreeReader> reader;
+
+    //Input branches registered by the analyzers, each branch is read once for all of them
+    std::shared_ptr<InputColumns> input;
+
+    //Output file the trees are attached to, only the first worker writes to the final file
+    TFile* outputFile;
+    std::string outputName;
+
+    //Vector with wished analyzers
+    std::vector<std::shared_ptr<BaseAnalyzer>> analyzers;
+
+    //Vector of trees and cutflow histograms for each analysis
+    std::vector<TTree*> outputTrees;
+    std::vector<CutFlow> cutflows;
+
+    //Bit i set if i-th channel needs the analyzer, for each analyzer
+    std::vector<unsigned int> channelMasks;
+
+    //Trigger objects and gen particle genealogy of the current event, shared by all analyzers
+    std::shared_ptr<TriggerObjectIndex> triggerObjects = std::make_shared<TriggerObjectIndex>();
+    std::shared_ptr<GenealogyTable> genealogy = std::make_shared<GenealogyTable>();
+
+    //Bit i set if event passed i-th channel, only used with single output tree
+    UChar_t channelMask = 0;
+
+    //Timing of read, analyzers and fill of this worker
+    PerformanceMonitor monitor;
+
+    //Entry range [first, last) of the input tree
+    Long64_t firstEntry;
+    Long64_t lastEntry;
+};
+
 class NanoSkimmer{
     private:
         //Measure execution time
         std::chrono::steady_clock::time_point start;
         std::chrono::steady_clock::time_point end;
 
-        //Input
+        //Input/Output
         std::string inFile;
+        std::string outFile;
         bool isData;
-        //Vector with wished analyzers
-        std::vector<std::shared_ptr<BaseAnalyzer>> analyzers;
-        
-        //Vector of trees for each analysis
-        std::vector<TTree*> outputTrees;
+        int nThreads;
 
-        //Vector of cutflow histograms for each analysis
-        std::vector<CutFlow> cutflows; 
-        std::map<std::string, std::vector<unsigned int>> nMin;
+        //Output tree settings, negative values for flush/save are in bytes
+        Long64_t autoFlush = -30000000;
+        Long64_t autoSave = -300000000;
+        int maxMemory = 1000;
+
+        //Write all channels in one tree "Events" with channel bitmask instead of one tree per channel
+        bool singleTree = false;
+
+        //Reject events on raw object counts before the object collections are read
+        bool stagedRead = false;
+
+        //Write NanoAOD like counter and C-array branches instead of std::vector branches
+        bool flatOutput = false;
+
+        //Write systematic variations of the objects next to nominal
+        bool systematics = false;
+
+        //Print timing summary and write JSON report next to the output file
+        bool performanceReport = false;
+
+        //Skip analyzers which no channel still passing needs, e.g. electrons if only muon channels are left
+        bool skipAnalyzers = false;
+
+        //Wall time of the event loop in seconds
+        double loopTime = 0.;
+
+        //One worker for each thread, first worker holds merged output at the end
+        std::vector<SkimWorker> workers;
+
+        //Number of entries in input tree
+        Long64_t nEntries;
 
         //Progress bar function
         void ProgressBar(const int &progress);
 
         //Configure analysis modules
-        void Configure(const float &xSec, TTreeReader& reader);
-        
+        std::vector<std::shared_ptr<BaseAnalyzer>> Configure(const float &xSec, TTreeReader& reader);
+
+        //Split input tree at cluster boundaries in ranges for each worker
+        std::vector<std::pair<Long64_t, Long64_t>> EntryRanges(TTree* tree, const int &nRanges);
+
+        //Loop over entry range of one worker, progress is shared between all workers
+        void Process(SkimWorker& worker, std::atomic<Long64_t> &processed, std::mutex &progressMutex);
 
     public:
         NanoSkimmer();
-        NanoSkimmer(const std::string &inFile, const bool &isData);
+        NanoSkimmer(const std::string &inFile, const std::string &outFile, const bool &isData, const int &nThreads = 1);
+        void SetOutputOptions(const Long64_t &autoFlush, const Long64_t &autoSave, const int &maxMemory);
+        void SetSingleTree(const bool &singleTree);
+        void SetStagedRead(const bool &stagedRead);
+        void SetFlatOutput(const bool &flatOutput);
+        void SetSystematics(const bool &systematics);
+        void SetPerformanceReport(const bool &performanceReport);
+        void SetSkipAnalyzers(const bool &skipAnalyzers);
         void EventLoop(const std::vector<std::string> &channels, const float &xSec = 1.);
-        void WriteOutput(const std::string &outFile); 
+        void WriteOutput();
 };
@@ -0,0 +1,72 @@
+#ifndef PERFORMANCEMONITOR_H
+#define PERFORMANCEMONITOR_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <typeinfo>
+
+#include <Rtypes.h>
+
+//Timing of the event loop, each skimming thread owns one instance and they are merged at the end
+//Per analyzer the cumulative time, a latency histogram and the number of events it rejected are kept
+class PerformanceMonitor {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+    private:
+        std::vector<std::string> names;
+
+        std::vector<double> analyzerTime;
+        std::vector<Long64_t> nCalls;
+        std::vector<Long64_t> nRejected;
+
+        //Latency histograms with logarithmic bins from minLatency on, first/last bin are under/overflow
+        static const int binsPerDecade = 4;
+        static const int nDecades = 8;
+        static constexpr double minLatency = 1e-7;
+        std::vector<std::vector<Long64_t>> latency;
+
+        //Time for reading the entry (NANO only) and for filling the output trees
+        double readTime = 0.;
+        double fillTime = 0.;
+        Long64_t nEvents = 0;
+
+        static unsigned int LatencyBin(const double &seconds);
+        static double BinEdge(const unsigned int &bin);
+
+        //Latency quantile estimated from the histogram
+        double Quantile(const unsigned int &i, const double &q) const;
+
+    public:
+        PerformanceMonitor();
+        PerformanceMonitor(const std::vector<std::string> &names);
+
+        static Clock::time_point Now(){return Clock::now();}
+        static double Seconds(const Clock::time_point &since){return std::chrono::duration<double>(Clock::now() - since).count();}
+
+        //Readable class name, e.g. of an analyzer
+        static std::string TypeName(const std::type_info &type);
+
+        void AddAnalyzer(const unsigned int &i, const double &seconds, const bool &rejected){
+            analyzerTime[i] += seconds;
+            nCalls[i]++;
+            nRejected[i] += rejected;
+            latency[i][LatencyBin(seconds)]++;
+        }
+
+        void AddRead(const double &seconds){readTime += seconds;}
+        void AddFill(const double &seconds){fillTime += seconds;}
+        void AddEvent(){nEvents++;}
+
+        void Merge(const PerformanceMonitor &other);
+
+        //Summary table on stdout and JSON report, wallTime is the duration of the event loop
+        void Print(const double &wallTime) const;
+        void WriteJSON(const std::string &fileName, const double &wallTime) const;
+
+        //Report file next to the output file, e.g. out.root -> out_performance.json
+        static std::string ReportName(const std::string &outFile);
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <vector>
+#include <cstdint>
+
+//Counter based random numbers (Philox4x32-10, Salmon et al., SC11)
+//Number i of an event only depends on (run, lumi, event, stream, i), not on thread or event order
+class Philox {
+    private:
+        std::uint32_t key[2] = {0, 0};
+        std::uint32_t counter[4] = {0, 0, 0, 0};
+
+        //Ten rounds of Philox on one 128 bit counter
+        static void Block(std::uint32_t (&values)[4], const std::uint32_t (&key)[2]);
+
+    public:
+        Philox();
+        Philox(const unsigned int &run, const unsigned int &lumi, const unsigned long long &event, const unsigned int &stream = 0);
+
+        //Standard normal number i of the event
+        float Gaus(const unsigned int &index) const;
+
+        //Standard normal numbers 0 to n-1 of the event
+        void Gaus(const unsigned int &n, std::vector<float> &values) const;
+};
+
+#endif
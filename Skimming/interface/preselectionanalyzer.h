@@ -0,0 +1,22 @@
+#ifndef PRESELECTIONANALYZER_H
+#define PRESELECTIONANALYZER_H
+
+#include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+
+class PreselectionAnalyzer : public BaseAnalyzer {
+    private:
+        //TTreeReaderValues with size of the raw collections
+        std::shared_ptr<InputValue<unsigned int>> nJet;
+        std::shared_ptr<InputValue<unsigned int>> nFatJet;
+        std::shared_ptr<InputValue<unsigned int>> nMuon;
+        std::shared_ptr<InputValue<unsigned int>> nElectron;
+
+    public:
+        PreselectionAnalyzer();
+        PreselectionAnalyzer(TTreeReader &reader);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
+        void EndJob(TFile* file);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef SCALEFACTORTABLE_H
+#define SCALEFACTORTABLE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include <TF1.h>
+
+//Flat copy of a 1D/2D scale factor histogram, so the ROOT file can be closed after reading
+//Values outside of the histogram range are taken from the closest bin instead of the under/overflow bins
+//A TF1 (e.g. pt dependent step functions) is copied and evaluated exactly, without uncertainty
+class ScaleFactorTable {
+    public:
+        struct ScaleFactor {
+            float value;
+            float error;
+        };
+
+    private:
+        //Inner bin edges, the first and last bin extend to -inf/+inf
+        std::vector<float> xEdges;
+        std::vector<float> yEdges;
+
+        //Bin (x, y) is at bins[x*nY + y], without under/overflow bins
+        std::vector<ScaleFactor> bins;
+        unsigned int nY = 1;
+
+        //Copy of the TF1 if the scale factor is a function, binning would move the steps of step functions
+        std::shared_ptr<TF1> function;
+
+        //Branchless bin search, counting inner edges below the value clamps to the edge bins
+        static unsigned int FindBin(const std::vector<float> &edges, const float &value){
+            unsigned int bin = 0;
+            for(const float &edge: edges) bin += value >= edge;
+
+            return bin;
+        }
+
+    public:
+        //Table with one bin, SF 1 without uncertainty
+        ScaleFactorTable();
+
+        //Read TH1/TH2 or TF1 with given name from the file
+        ScaleFactorTable(const std::string &fileName, const std::string &objectName);
+
+        ScaleFactor Get(const float &x, const float &y = 0.) const {
+            if(function) return {float(function->Eval(x)), 0.};
+
+            return bins[FindBin(xEdges, x)*nY + FindBin(yEdges, y)];
+        }
+};
+
+#endif
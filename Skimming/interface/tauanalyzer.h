@@ -2,6 +2,7 @@
 #define TAUANALYZER_H
 
 #include <ChargedAnalysis/Skimming/interface/baseanalyzer.h>
+#include <ChargedAnalysis/Skimming/interface/scalefactortable.h>
 
 //Tau class to be saved in tree
 struct Tau {
@@ -34,21 +35,16 @@ class TauAnalyzer: public BaseAnalyzer {
         std::map<int, std::string> antiMuSFfiles;
         std::map<int, std::string> antiEleSFfiles;
 
-        //Hist with scale factors
-        TF1* tauIdSFhist;
-	TH1F* antiMuSFhist;
-	TH1F* antiEleSFhist;
+        //Scale factors, ID in pt and anti lepton discriminators in |eta|
+        ScaleFactorTable tauIdSF;
+        ScaleFactorTable antiMuSF;
+        ScaleFactorTable antiEleSF;
 
         //Kinematic cut criteria
         int era;
         float ptCut;
         float etaCut;
 
-        //EDM Token for MINIAOD analysis
-        tToken tauToken;
-        trigObjToken triggerObjToken;
-        genPartToken genParticleToken;
-
         //Vector with output varirables of the output tree
         std::vector<std::string> floatNames;
         std::vector<std::string> boolNames;
@@ -59,32 +55,32 @@ class TauAnalyzer: public BaseAnalyzer {
         std::vector<std::vector<int>> intVariables;
 
         //TTreeReader Values for NANO AOD analysis
-        std::unique_ptr<TTreeReaderArray<float>> tauPt;
-        std::unique_ptr<TTreeReaderArray<float>> tauEta;
-        std::unique_ptr<TTreeReaderArray<float>> tauPhi;
-        std::unique_ptr<TTreeReaderArray<float>> tauIso;
-        std::unique_ptr<TTreeReaderArray<int>> tauCharge;
-        std::unique_ptr<TTreeReaderArray<unsigned int>> nTau;
-        std::unique_ptr<TTreeReaderArray<int>> tauDM;
-        std::unique_ptr<TTreeReaderArray<unsigned char>> tauAntiEl;
-        std::unique_ptr<TTreeReaderArray<unsigned char>> tauAntiMu;
-        std::unique_ptr<TTreeReaderArray<unsigned char>> tauDM2017new;
-        std::unique_ptr<TTreeReaderArray<unsigned char>> tauDM2017old;
-        std::unique_ptr<TTreeReaderArray<bool>> tauIdDM;
-
-      /*  std::unique_ptr<TTreeReaderArray<int>> nTaus;
-        std::unique_ptr<TTreeReaderArray<int>> AntiEl;
-        std::unique_ptr<TTreeReaderArray<int>> AntiMu;
-        std::unique_ptr<TTreeReaderArray<int>> DMnew;
-        std::unique_ptr<TTreeReaderArray<int>> DMold;*/
+        std::shared_ptr<InputArray<float>> tauPt;
+        std::shared_ptr<InputArray<float>> tauEta;
+        std::shared_ptr<InputArray<float>> tauPhi;
+        std::shared_ptr<InputArray<float>> tauIso;
+        std::shared_ptr<InputArray<int>> tauCharge;
+        std::shared_ptr<InputArray<unsigned int>> nTau;
+        std::shared_ptr<InputArray<int>> tauDM;
+        std::shared_ptr<InputArray<unsigned char>> tauAntiEl;
+        std::shared_ptr<InputArray<unsigned char>> tauAntiMu;
+        std::shared_ptr<InputArray<unsigned char>> tauDM2017new;
+        std::shared_ptr<InputArray<unsigned char>> tauDM2017old;
+        std::shared_ptr<InputArray<bool>> tauIdDM;
+
+      /*  std::shared_ptr<InputArray<int>> nTaus;
+        std::shared_ptr<InputArray<int>> AntiEl;
+        std::shared_ptr<InputArray<int>> AntiMu;
+        std::shared_ptr<InputArray<int>> DMnew;
+        std::shared_ptr<InputArray<int>> DMold;*/
 
     public:
-        TauAnalyzer(const int &era, const float &ptCut, const float &etaCut, tToken& tauToken, trigObjToken& triggerObjToken, genPartToken& genParticleToken);
+        TauAnalyzer(const int &era, const float &ptCut, const float &etaCut);
         TauAnalyzer(const int &era, const float &ptCut, const float &etaCut, TTreeReader& reader);
 
 	int SetGenParticles(const int &i, const int &pdgID);
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
         void EndJob(TFile* file);
 };
 
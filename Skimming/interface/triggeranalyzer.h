@@ -2,6 +2,7 @@
 #define TRIGGERANALYZER_H
 
 #include <ChargedSkimming/Skimming/interface/baseanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/triggerpathindex.h>
 
 #include <numeric>
 
@@ -10,21 +11,27 @@ class TriggerAnalyzer : public BaseAnalyzer {
         //Trigger strings and vector with values
         std::vector<std::string> muPaths;
         std::vector<std::string> elePaths;
-        std::vector<std::unique_ptr<TTreeReaderValue<bool>>> triggerEle;
-        std::vector<std::unique_ptr<TTreeReaderValue<bool>>> triggerMu;
+        std::vector<std::shared_ptr<InputValue<bool>>> triggerEle;
+        std::vector<std::shared_ptr<InputValue<bool>>> triggerMu;
 
-        //EDM Token for MINIAOD analysis
-        trigToken triggerToken;
+        //Position of the paths in the trigger results with MINIAOD
+        TriggerPathIndex muIndex;
+        TriggerPathIndex eleIndex;
         
+        //Cut step of the muon and electron triggers in each cutflow
+        std::vector<unsigned int> muSteps;
+        std::vector<unsigned int> eleSteps;
+
         //Vector with triger results
         std::vector<int> muResults;
         std::vector<int> eleResults;
 
     public:
         TriggerAnalyzer(const std::vector<std::string> &muPaths, const std::vector<std::string> &elePaths, TTreeReader &reader);
-        TriggerAnalyzer(const std::vector<std::string> &muPaths, const std::vector<std::string> &elePaths, trigToken& triggerToken);
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        TriggerAnalyzer(const std::vector<std::string> &muPaths, const std::vector<std::string> &elePaths);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
+        bool NeedsProducedCollections() const {return false;}
         void EndJob(TFile* file);
 };
 
@@ -0,0 +1,54 @@
+#ifndef TRIGGEROBJECTINDEX_H
+#define TRIGGEROBJECTINDEX_H
+
+#include <vector>
+#include <array>
+#include <cstdint>
+
+#include <ChargedSkimming/Skimming/interface/inputcolumns.h>
+
+#include <DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h>
+
+//Trigger objects of one event, partitioned by object type and shared by all analyzers of a skimming thread
+//Built by the first analyzer asking for a match, the skimmer clears it before each event
+class TriggerObjectIndex {
+    public:
+        //Electron and photon HLT objects are both e/gamma candidates
+        enum ObjectType {EGAMMA, MUON, TAU, JET, OTHER, NTYPES};
+
+    private:
+        bool isBuilt = false;
+
+        //Objects of type t are at typeStart[t] to typeStart[t+1] of the SoA
+        std::array<unsigned int, NTYPES + 1> typeStart = {};
+        std::vector<float> pts;
+        std::vector<float> etas;
+        std::vector<float> phis;
+        std::vector<std::uint32_t> filterBits;
+
+        //Unsorted objects before partitioning
+        std::vector<unsigned char> inputTypes;
+        std::vector<std::array<float, 3>> inputP4;
+        std::vector<std::uint32_t> inputBits;
+
+        void Add(const ObjectType &type, const float &pt, const float &eta, const float &phi, const std::uint32_t &bits);
+        void Partition();
+
+    public:
+        //Mark as outdated, done by the skimmer for each new event
+        void Clear();
+        bool IsBuilt() const;
+
+        //NANO: TrigObj_id is the pdg ID of the object (1/6 for jets), filter bits are TrigObj_filterBits
+        void Build(const ColumnView<int> &id, const ColumnView<float> &pt, const ColumnView<float> &eta, const ColumnView<float> &phi, const ColumnView<int> &bits);
+
+        //MINI: type from the trigger object types, no filter bits available
+        void Build(const std::vector<pat::TriggerObjectStandAlone> &trigObj);
+
+        //True if an object of the type has dR < maxDeltaR, |pt - objPt| < maxRelPt*pt and all bits of filterMask set
+        bool Match(const ObjectType &type, const float &pt, const float &eta, const float &phi, const float &maxDeltaR = 0.5, const float &maxRelPt = 0.5, const std::uint32_t &filterMask = 0) const;
+
+        static ObjectType TypeFromID(const int &id);
+};
+
+#endif
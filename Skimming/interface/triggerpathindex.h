@@ -0,0 +1,36 @@
+#ifndef TRIGGERPATHINDEX_H
+#define TRIGGERPATHINDEX_H
+
+#include <vector>
+#include <string>
+
+#include <DataFormats/Common/interface/TriggerResults.h>
+#include <FWCore/Common/interface/TriggerNames.h>
+#include <DataFormats/Provenance/interface/ParameterSetID.h>
+
+//Position of configured trigger paths/filters in the TriggerResults of MINIAOD
+//Names are resolved only if the trigger menu (parameter set of the TriggerNames) changes
+class TriggerPathIndex {
+    private:
+        std::vector<std::string> paths;
+
+        //Index in the TriggerResults for each path, -1 if not in the menu
+        std::vector<int> pathIndex;
+
+        bool isResolved = false;
+        edm::ParameterSetID menuID;
+
+        //Name is the path itself or a version of it, e.g. HLT_IsoMu27 or HLT_IsoMu27_v13
+        static bool IsVersionOf(const std::string &name, const std::string &path);
+
+    public:
+        TriggerPathIndex(const std::vector<std::string> &paths = {});
+
+        //Resolve names again if the trigger menu changed
+        void Update(const edm::TriggerNames &names);
+
+        //Result of path i, -1 if not in the menu
+        int Accept(const unsigned int &i, const edm::TriggerResults &results) const;
+};
+
+#endif
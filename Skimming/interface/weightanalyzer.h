@@ -21,26 +21,24 @@ class WeightAnalyzer : public BaseAnalyzer {
         //Lumi information
         std::map<int, float> lumis;
 
-        //Token for MINIAOD
-        puToken pileupToken;
-        genToken geninfoToken;
-
         //Histograms
         TH1F* puMC; 
         TH1F* nGenHist;
         TH1F* nGenWeightedHist;
 
         //TTreeReader Values
-        std::unique_ptr<TTreeReaderValue<float>> nPU;
-        std::unique_ptr<TTreeReaderValue<float>> genWeightValue;
-        std::unique_ptr<TTreeReaderValue<ULong64_t>> evtNumber;
+        std::shared_ptr<InputValue<float>> nPU;
+        std::shared_ptr<InputValue<float>> genWeightValue;
+        std::shared_ptr<InputValue<ULong64_t>> evtNumber;
 
 
     public:
         WeightAnalyzer(const float era, const float xSec, TTreeReader &reader);
-        WeightAnalyzer(const float era, const float xSec, puToken &pileupToken, genToken &geninfoToken);
-        void BeginJob(std::vector<TTree*>& trees, bool &isData);
-        void Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event);
+        WeightAnalyzer(const float era, const float xSec);
+        void BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows);
+        void Analyze(std::vector<CutFlow> &cutflows, EventContext* context);
+        bool NeedsProducedCollections() const {return false;}
+        void Merge(const std::shared_ptr<BaseAnalyzer>& other);
         void EndJob(TFile* file);
 };
 
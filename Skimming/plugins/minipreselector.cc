@@ -0,0 +1,82 @@
+#include <ChargedSkimming/Skimming/interface/minipreselector.h>
+
+#include <algorithm>
+
+MiniPreSelector::MiniPreSelector(const edm::ParameterSet& iConfig):
+      channels(iConfig.getParameter<std::vector<std::string>>("channels")),
+      muTriggers(iConfig.getParameter<std::vector<std::string>>("muTriggers")),
+      eleTriggers(iConfig.getParameter<std::vector<std::string>>("eleTriggers")),
+      isData(iConfig.getParameter<bool>("isData")){
+
+        //Tokens
+        tokens.jets = consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("jets"));
+        tokens.fatJets = consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("fatjets"));
+        tokens.electrons = consumes<std::vector<pat::Electron>>(iConfig.getParameter<edm::InputTag>("electrons"));
+        tokens.muons = consumes<std::vector<pat::Muon>>(iConfig.getParameter<edm::InputTag>("muons"));
+        tokens.triggers = consumes<edm::TriggerResults>(iConfig.getParameter<edm::InputTag>("trigger"));
+
+        //Decision is also put into the event, so the skimmer knows which collections were produced
+        produces<bool>();
+}
+
+std::unique_ptr<PreselectionStream> MiniPreSelector::beginStream(edm::StreamID streamID) const {
+    std::lock_guard<std::mutex> lock(streamMutex);
+
+    std::unique_ptr<PreselectionStream> stream = std::make_unique<PreselectionStream>();
+    stream->context = EventContext(tokens);
+
+    stream->cutflows = CutFlow::Channels(channels);
+
+    stream->analyzers = {
+        std::shared_ptr<TriggerAnalyzer>(new TriggerAnalyzer(muTriggers, eleTriggers)),
+        std::shared_ptr<MetFilterAnalyzer>(new MetFilterAnalyzer(2017)),
+        std::shared_ptr<PreselectionAnalyzer>(new PreselectionAnalyzer()),
+    };
+
+    //No output trees, only the cutflow decisions are used
+    std::vector<TTree*> trees;
+    bool isData = this->isData;
+
+    for(std::shared_ptr<BaseAnalyzer> analyzer: stream->analyzers){
+        analyzer->BeginJob(trees, isData, stream->cutflows);
+    }
+
+    return stream;
+}
+
+bool MiniPreSelector::filter(edm::StreamID streamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const {
+    PreselectionStream* stream = streamCache(streamID);
+
+    nEvents++;
+    stream->context.SetEvent(iEvent);
+
+    //Call each analyzer, stop if all channels failed
+    for(std::shared_ptr<BaseAnalyzer> analyzer: stream->analyzers){
+        analyzer->Analyze(stream->cutflows, &stream->context);
+
+        if(std::none_of(stream->cutflows.begin(), stream->cutflows.end(), [](const CutFlow &cutflow){return cutflow.passed;})){
+            break;
+        }
+    }
+
+    bool accepted = false;
+
+    for(CutFlow &cutflow: stream->cutflows){
+        accepted = accepted or cutflow.passed;
+        cutflow.Reset();
+    }
+
+    nAccepted += accepted;
+    iEvent.put(std::make_unique<bool>(accepted));
+
+    return accepted;
+}
+
+void MiniPreSelector::endJob(){
+    long long nEvents = this->nEvents, nAccepted = this->nAccepted;
+
+    std::cout << "Preselection: Accepted " << nAccepted << " events of " << nEvents << " (" << 100*(float)nAccepted/std::max(nEvents, 1LL) << "%)" << std::endl;
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(MiniPreSelector);
@@ -1,144 +1,317 @@
 #include <ChargedSkimming/Skimming/interface/miniskimmer.h>
 
+#include <algorithm>
+#include <cstdio>
+
+
 MiniSkimmer::MiniSkimmer(const edm::ParameterSet& iConfig):
-      //Tokens
-      jetToken(consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("jets"))),
-      fatjetToken(consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("fatjets"))),
-      genjetToken(consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genjets"))),
-      genfatjetToken(consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genfatjets"))),
-      metToken(consumes<std::vector<pat::MET>>(iConfig.getParameter<edm::InputTag>("mets"))),
-      eleToken(consumes<std::vector<pat::Electron>>(iConfig.getParameter<edm::InputTag>("electrons"))),
-      muonToken(consumes<std::vector<pat::Muon>>(iConfig.getParameter<edm::InputTag>("muons"))),
-      triggerToken(consumes<edm::TriggerResults>(iConfig.getParameter<edm::InputTag>("trigger"))),
-      triggerObjToken(consumes<std::vector<pat::TriggerObjectStandAlone>>(iConfig.getParameter<edm::InputTag>("triggerObjects"))),
-      pileupToken(consumes<std::vector<PileupSummaryInfo>>(iConfig.getParameter<edm::InputTag>("pileUp"))),
-      geninfoToken(consumes<GenEventInfoProduct>(iConfig.getParameter<edm::InputTag>("genInfo"))),
-      genParticleToken(consumes<std::vector<reco::GenParticle>>(iConfig.getParameter<edm::InputTag>("genPart"))),
-      rhoToken(consumes<double>(iConfig.getParameter<edm::InputTag>("rho"))),
-      vertexToken(consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vtx"))),
-      secVertexToken(consumes<std::vector<reco::VertexCompositePtrCandidate>>(iConfig.getParameter<edm::InputTag>("svtx"))),
-
-      //Other stuff
       channels(iConfig.getParameter<std::vector<std::string>>("channels")),
+      muTriggers(iConfig.getParameter<std::vector<std::string>>("muTriggers")),
+      eleTriggers(iConfig.getParameter<std::vector<std::string>>("eleTriggers")),
       xSec(iConfig.getParameter<double>("xSec")),
       outFile(iConfig.getParameter<std::string>("outFile")),
-      isData(iConfig.getParameter<bool>("isData")){
+      isData(iConfig.getParameter<bool>("isData")),
+      autoFlush(iConfig.getParameter<long long>("autoFlush")),
+      autoSave(iConfig.getParameter<long long>("autoSave")),
+      maxMemory(iConfig.getParameter<int>("maxMemory")),
+      singleTree(iConfig.getParameter<bool>("singleTree")),
+      flatOutput(iConfig.getParameter<bool>("flatOutput")),
+      systematics(iConfig.getParameter<bool>("systematics")),
+      performanceReport(iConfig.getParameter<bool>("performanceReport")),
+      skipAnalyzers(iConfig.getParameter<bool>("skipAnalyzers")){
 
         start = std::chrono::steady_clock::now();
+
+        //Tokens
+        tokens.jets = consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("jets"));
+        tokens.fatJets = consumes<std::vector<pat::Jet>>(iConfig.getParameter<edm::InputTag>("fatjets"));
+        tokens.genJets = consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genjets"));
+        tokens.genFatJets = consumes<std::vector<reco::GenJet>>(iConfig.getParameter<edm::InputTag>("genfatjets"));
+        tokens.MET = consumes<std::vector<pat::MET>>(iConfig.getParameter<edm::InputTag>("mets"));
+        tokens.electrons = consumes<std::vector<pat::Electron>>(iConfig.getParameter<edm::InputTag>("electrons"));
+        tokens.muons = consumes<std::vector<pat::Muon>>(iConfig.getParameter<edm::InputTag>("muons"));
+        tokens.triggers = consumes<edm::TriggerResults>(iConfig.getParameter<edm::InputTag>("trigger"));
+        tokens.triggerObjects = consumes<std::vector<pat::TriggerObjectStandAlone>>(iConfig.getParameter<edm::InputTag>("triggerObjects"));
+        tokens.pileUp = consumes<std::vector<PileupSummaryInfo>>(iConfig.getParameter<edm::InputTag>("pileUp"));
+        tokens.genInfo = consumes<GenEventInfoProduct>(iConfig.getParameter<edm::InputTag>("genInfo"));
+        tokens.genParticles = consumes<std::vector<reco::GenParticle>>(iConfig.getParameter<edm::InputTag>("genPart"));
+        tokens.rho = consumes<double>(iConfig.getParameter<edm::InputTag>("rho"));
+        tokens.vertices = consumes<std::vector<reco::Vertex>>(iConfig.getParameter<edm::InputTag>("vtx"));
+        tokens.secVertices = consumes<std::vector<reco::VertexCompositePtrCandidate>>(iConfig.getParameter<edm::InputTag>("svtx"));
+
+        //Empty label if no preselection is used
+        edm::InputTag preselection = iConfig.getParameter<edm::InputTag>("preselection");
+        hasPreselection = preselection.label() != "";
+        if(hasPreselection) preselectionToken = consumes<bool>(preselection);
+
+        //Channel bits are stored in one byte
+        if(singleTree and channels.size() > 8){
+            std::cout << "Single output tree supports at most 8 channels, write one tree per channel" << std::endl;
+            singleTree = false;
+        }
 }
 
 MiniSkimmer::~MiniSkimmer(){
     end = std::chrono::steady_clock::now();
     std::cout << "Finished event loop (in seconds): " << std::chrono::duration_cast<std::chrono::seconds>(end - start).count() << std::endl;
-
-    //Print stats
-    for(TTree* tree: outputTrees){
-        std::cout << tree->GetName() << " analysis: Selected " << tree->GetEntries() << " events of " << nEvents << " (" << 100*(float)tree->GetEntries()/nEvents << "%)" << std::endl;
-    }
 }
 
-void MiniSkimmer::beginJob(){
-    //Set analyzer modules for each final state
-    std::vector<jToken> jetTokens = {jetToken, fatjetToken};
-    std::vector<genjToken> genjetTokens = {genjetToken, genfatjetToken};
-
-    nMin = {
-            {"mu4j", {1, 0, 4, 0}},
-            {"e4j", {0, 1, 4, 0}},
-            {"mu2j1f", {1, 0, 2, 1}},
-            {"e2j1f", {0, 1, 2, 1}},
-            {"mu2f", {1, 0, 0, 2}},
-            {"e2f", {0, 1, 0, 2}},
-    };
+std::unique_ptr<std::shared_ptr<SkimStream>> MiniSkimmer::beginStream(edm::StreamID streamID) const {
+    //Analyzers read their calibration files in BeginJob, so set up one stream after another
+    std::lock_guard<std::mutex> lock(streamMutex);
 
-    for(const std::string &channel: channels){
-        //Create output trees
+    std::shared_ptr<SkimStream> stream = std::make_shared<SkimStream>();
+    stream->context = EventContext(tokens);
+
+    //Other streams write into temporary files which are appended in endJob
+    stream->outputName = streamID.value() == 0 ? outFile : outFile.substr(0, outFile.rfind(".root")) + "_stream" + std::to_string(streamID.value()) + ".root";
+    stream->outputFile = TFile::Open(stream->outputName.c_str(), "RECREATE");
+
+    std::vector<std::string> treeNames = singleTree ? std::vector<std::string>{"Events"} : channels;
+
+    //Memory budget of the stream shared by all output trees
+    Long64_t flushBytes = -Long64_t(maxMemory)*1024*1024/Long64_t(treeNames.size());
+    if(autoFlush < 0) flushBytes = std::max(flushBytes, Long64_t(autoFlush));
+
+    for(const std::string &treeName: treeNames){
+        //Create output trees, attached to output file so baskets are written while filling
         TTree* tree = new TTree();
-        tree->SetName(channel.c_str());
-        outputTrees.push_back(tree);
-
-        //Create cutflow histograms
-        CutFlow cutflow;
-
-        cutflow.hist = new TH1F();
-        cutflow.hist->SetName(("cutflow_" + channel).c_str());
-        cutflow.hist->SetName(("cutflow_" + channel).c_str());
-        cutflow.hist->GetYaxis()->SetName("Events");
-
-        cutflow.nMinMu=nMin[channel][0];
-        cutflow.nMinEle=nMin[channel][1];
-        cutflow.nMinJet=nMin[channel][2];
-        cutflow.nMinFatjet=nMin[channel][3];
-        
-        cutflow.weight = 1;    
-
-        cutflows.push_back(cutflow); 
-    }
-
-    analyzers = {
-        std::shared_ptr<WeightAnalyzer>(new WeightAnalyzer(2017, xSec, pileupToken, geninfoToken)),
-        std::shared_ptr<TriggerAnalyzer>(new TriggerAnalyzer({"HLT_IsoMu27"}, {"HLT_Ele35_WPTight_Gsf", "HLT_Ele28_eta2p1_WPTight_Gsf_HT150", "HLT_Ele30_eta2p1_WPTight_Gsf_CentralPFJet35_EleCleaned"}, triggerToken)),
-        std::shared_ptr<MetFilterAnalyzer>(new MetFilterAnalyzer(2017, triggerToken)),
-        std::shared_ptr<JetAnalyzer>(new JetAnalyzer(2017, 30., 2.4, jetTokens, genjetTokens, metToken, rhoToken, genParticleToken, secVertexToken)),
-        std::shared_ptr<MuonAnalyzer>(new MuonAnalyzer(2017, 20., 2.4, muonToken, triggerObjToken, genParticleToken)),
-        std::shared_ptr<ElectronAnalyzer>(new ElectronAnalyzer(2017, 20., 2.4, eleToken, triggerObjToken, genParticleToken)),
-        std::shared_ptr<GenPartAnalyzer>(new GenPartAnalyzer(genParticleToken)),
+        tree->SetName(treeName.c_str());
+        tree->SetDirectory(stream->outputFile);
+        tree->SetAutoFlush(autoFlush < 0 ? flushBytes : autoFlush);
+        tree->SetAutoSave(autoSave);
+        stream->outputTrees.push_back(tree);
+    }
+
+    if(singleTree){
+        TTree* tree = stream->outputTrees[0];
+        tree->Branch("channelMask", &stream->channelMask, "channelMask/b");
+
+        //Select channel in the output with e.g. tree->Draw("...", "mu4j")
+        for(unsigned int i = 0; i < channels.size(); i++){
+            tree->SetAlias(channels[i].c_str(), ("(channelMask & " + std::to_string(1 << i) + ") != 0").c_str());
+        }
+    }
+
+    //Create cutflow of each channel
+    stream->cutflows = CutFlow::Channels(channels);
+
+    //Channel decision of each JES/JER variation, events only passing in a variation are written too
+    if(systematics and !isData){
+        for(unsigned int i = 0; i < channels.size(); i++){
+            TTree* tree = singleTree ? stream->outputTrees[0] : stream->outputTrees[i];
+            tree->Branch(("variations_" + channels[i]).c_str(), &stream->cutflows[i].passedVariations, ("variations_" + channels[i] + "/i").c_str());
+        }
+    }
+
+    //Set analyzer modules for each final state
+    stream->analyzers = {
+        std::shared_ptr<WeightAnalyzer>(new WeightAnalyzer(2017, xSec)),
+        std::shared_ptr<TriggerAnalyzer>(new TriggerAnalyzer(muTriggers, eleTriggers)),
+        std::shared_ptr<MetFilterAnalyzer>(new MetFilterAnalyzer(2017)),
+        std::shared_ptr<JetAnalyzer>(new JetAnalyzer(2017, 30., 2.4)),
+        std::shared_ptr<MuonAnalyzer>(new MuonAnalyzer(2017, 20., 2.4)),
+        std::shared_ptr<ElectronAnalyzer>(new ElectronAnalyzer(2017, 20., 2.4)),
+        std::shared_ptr<GenPartAnalyzer>(new GenPartAnalyzer()),
     };
 
     //Begin jobs for all analyzers
-    for(std::shared_ptr<BaseAnalyzer> analyzer: analyzers){
-        analyzer->BeginJob(outputTrees, isData);
+    bool isData = this->isData;
+    std::vector<std::string> analyzerNames;
+
+    for(std::shared_ptr<BaseAnalyzer> analyzer: stream->analyzers){
+        analyzer->SetFlatOutput(flatOutput);
+        analyzer->SetSystematics(systematics);
+        analyzer->SetTriggerObjects(stream->triggerObjects);
+        analyzer->SetGenealogy(stream->genealogy);
+        analyzer->BeginJob(stream->outputTrees, isData, stream->cutflows);
+        stream->channelMasks.push_back(analyzer->ChannelMask(stream->cutflows));
+
+        analyzerNames.push_back(PerformanceMonitor::TypeName(typeid(*analyzer)));
     }
+
+    stream->monitor = PerformanceMonitor(analyzerNames);
+
+    //Register stream at position of its ID, so output is merged in fixed order
+    if(streams.size() <= streamID.value()) streams.resize(streamID.value() + 1);
+    streams[streamID.value()] = stream;
+
+    return std::make_unique<std::shared_ptr<SkimStream>>(stream);
 }
 
-void MiniSkimmer::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup){
-    nEvents++;
+void MiniSkimmer::analyze(edm::StreamID streamID, const edm::Event& iEvent, const edm::EventSetup& iSetup) const {
+    SkimStream* stream = streamCache(streamID)->get();
+
+    stream->nEvents++;
+    stream->context.SetEvent(iEvent);
+    stream->triggerObjects->Clear();
+    stream->genealogy->Clear();
     unsigned int nFailed = 0;
 
-    //Call each analyzer
-    for(unsigned int i = 0; i < analyzers.size(); i++){
+    //Object collections of events failing the preselection were not produced, only event level analyzers run for the weights and cutflows
+    bool preselected = true;
+
+    if(hasPreselection){
+        edm::Handle<bool> preselection;
+        iEvent.getByToken(preselectionToken, preselection);
+
+        preselected = *preselection;
+    }
+
+    //Input is read by the framework on demand, so read time is part of the analyzer time
+    PerformanceMonitor::Clock::time_point time;
+
+    //Bit i set if i-th channel is still passing in nominal or a variation
+    unsigned int passedMask = (1 << stream->cutflows.size()) - 1;
+
+    //Call each analyzer, skipped analyzers do not request their products from the event
+    for(unsigned int i = 0; i < stream->analyzers.size(); i++){
+        if(!preselected and stream->analyzers[i]->NeedsProducedCollections()) continue;
         nFailed = 0;
-        analyzers[i]->Analyze(cutflows, &iEvent);
 
-        for(CutFlow &cutflow: cutflows){
-            if(!cutflow.passed) nFailed++;
+        if(skipAnalyzers and (stream->channelMasks[i] & passedMask) == 0){
+            stream->analyzers[i]->Clear();
+            continue;
+        }
+
+        time = PerformanceMonitor::Now();
+        stream->analyzers[i]->Analyze(stream->cutflows, &stream->context);
+
+        for(unsigned int j = 0; j < stream->cutflows.size(); j++){
+            if(!stream->cutflows[j].Keep()){
+                nFailed++;
+                passedMask &= ~(1 << j);
+            }
         }
 
+        stream->monitor.AddAnalyzer(i, PerformanceMonitor::Seconds(time), nFailed == stream->cutflows.size());
+
         //If for all channels one analyzer fails, reject event
-        if(nFailed == cutflows.size()){
+        if(nFailed == stream->cutflows.size()){
             break;
-        }        
+        }
+    }
+
+    //Preselection failed in every channel, also if the event level analyzers passed
+    if(!preselected){
+        for(CutFlow &cutflow: stream->cutflows) cutflow.Reject();
     }
 
     //Check individual for each channel, if event should be filled
-    for(unsigned int i = 0; i < outputTrees.size(); i++){
-        if(cutflows[i].passed){
-            outputTrees[i]->Fill();
+    time = PerformanceMonitor::Now();
+    stream->channelMask = 0;
+
+    //Nominal decision is counted and stored in the channel mask, events passing only in a variation are written as well
+    bool keep = false;
+
+    for(unsigned int i = 0; i < stream->cutflows.size(); i++){
+        if(stream->cutflows[i].passed){
+            stream->cutflows[i].nPassed++;
+            stream->channelMask |= 1 << i;
         }
 
-        cutflows[i].passed = true;
+        if(stream->cutflows[i].Keep()){
+            keep = true;
+            if(!singleTree) stream->outputTrees[i]->Fill();
+        }
+    }
+
+    //Event is written once if it passed any channel
+    if(singleTree and keep){
+        stream->outputTrees[0]->Fill();
     }
+
+    for(CutFlow &cutflow: stream->cutflows) cutflow.Reset();
+
+    stream->monitor.AddFill(PerformanceMonitor::Seconds(time));
+    stream->monitor.AddEvent();
 }
 
 void MiniSkimmer::endJob(){
-    TFile* file = TFile::Open(outFile.c_str(), "RECREATE");
-    
-    for(TTree* tree: outputTrees){
+    //Drop IDs of streams which were never started
+    streams.erase(std::remove(streams.begin(), streams.end(), nullptr), streams.end());
+    if(streams.empty()) return;
+
+    std::shared_ptr<SkimStream> merged = streams[0];
+
+    //Print stats
+    int nEvents = 0;
+    for(const std::shared_ptr<SkimStream> &stream: streams) nEvents += stream->nEvents;
+
+    for(unsigned int i = 0; i < channels.size(); i++){
+        Long64_t nSelected = 0;
+
+        for(const std::shared_ptr<SkimStream> &stream: streams){
+            nSelected += stream->cutflows[i].nPassed;
+        }
+
+        std::cout << channels[i] << " analysis: Selected " << nSelected << " events of " << nEvents << " (" << 100*(float)nSelected/nEvents << "%)" << std::endl;
+    }
+
+    //Merge cutflows and analyzer results of the other streams into the first one
+    for(unsigned int s = 1; s < streams.size(); s++){
+        for(unsigned int i = 0; i < merged->analyzers.size(); i++){
+            merged->analyzers[i]->Merge(streams[s]->analyzers[i]);
+        }
+
+        for(unsigned int i = 0; i < merged->cutflows.size(); i++){
+            merged->cutflows[i].Merge(streams[s]->cutflows[i]);
+        }
+
+        merged->monitor.Merge(streams[s]->monitor);
+
+        //Finish temporary output, closing the file deletes the trees
+        streams[s]->outputFile->cd();
+
+        for(TTree* tree: streams[s]->outputTrees){
+            tree->Write();
+        }
+
+        streams[s]->outputFile->Close();
+    }
+
+    //Append trees of other streams, baskets are copied without decompressing
+    for(unsigned int s = 1; s < streams.size(); s++){
+        TFile* file = TFile::Open(streams[s]->outputName.c_str(), "READ");
+
+        for(TTree* tree: merged->outputTrees){
+            TTree* otherTree = (TTree*)file->Get(tree->GetName());
+            tree->CopyEntries(otherTree, -1, "fast");
+        }
+
+        file->Close();
+        std::remove(streams[s]->outputName.c_str());
+    }
+
+    TFile* file = merged->outputFile;
+    file->cd();
+
+    for(TTree* tree: merged->outputTrees){
         tree->Write();
     }
 
     //End jobs for all analyzers
-    for(unsigned int i = 0; i < analyzers.size(); i++){
-        analyzers[i]->EndJob(file);
+
+    for(unsigned int i = 0; i < merged->analyzers.size(); i++){
+        merged->analyzers[i]->EndJob(file);
     }
 
-    for(CutFlow& cutflow: cutflows){
-        cutflow.hist->Write();
-        delete cutflow.hist;
+    for(CutFlow& cutflow: merged->cutflows){
+        cutflow.Write();
     }
 
     file->Write();
     file->Close();
+
+    if(performanceReport){
+        double wallTime = PerformanceMonitor::Seconds(start);
+
+        merged->monitor.Print(wallTime);
+        merged->monitor.WriteJSON(PerformanceMonitor::ReportName(outFile), wallTime);
+        std::cout << "Performance report created: " + PerformanceMonitor::ReportName(outFile) << std::endl;
+    }
+
+    streams.clear();
 }
 
 //define this as a plug-in
@@ -16,6 +16,16 @@ options.register("filename", "", VarParsing.multiplicity.list, VarParsing.varTyp
 "Name of file for skimming")
 options.register("outname", "outputSkim.root", VarParsing.multiplicity.singleton, VarParsing.varType.string, "Name of file for output")
 options.register("outdir", "{}/src".format(os.environ["CMSSW_BASE"]), VarParsing.multiplicity.singleton, VarParsing.varType.string, "Dir of file for output")
+options.register("threads", 1, VarParsing.multiplicity.singleton, VarParsing.varType.int, "Number of threads/streams used by cmsRun")
+options.register("autoflush", -30000000, VarParsing.multiplicity.singleton, VarParsing.varType.int, "AutoFlush of output trees (negative values in bytes)")
+options.register("autosave", -300000000, VarParsing.multiplicity.singleton, VarParsing.varType.int, "AutoSave of output trees (negative values in bytes)")
+options.register("singletree", False, VarParsing.multiplicity.singleton, VarParsing.varType.bool, "Write all channels in one tree with channel bitmask")
+options.register("flatoutput", False, VarParsing.multiplicity.singleton, VarParsing.varType.bool, "Write NanoAOD like flat branches instead of std::vector branches")
+options.register("systematics", False, VarParsing.multiplicity.singleton, VarParsing.varType.bool, "Write JES/JER variations next to nominal jets")
+options.register("performancereport", False, VarParsing.multiplicity.singleton, VarParsing.varType.bool, "Print timing per analyzer and write JSON report next to the output file")
+options.register("skipanalyzers", False, VarParsing.multiplicity.singleton, VarParsing.varType.bool, "Skip analyzers no remaining channel needs, e.g. electrons in events only passing muon channels (their branches stay empty)")
+options.register("preselection", True, VarParsing.multiplicity.singleton, VarParsing.varType.bool, "Reject events with trigger, MET filters and object multiplicities before running the jet and egamma producers")
+options.register("maxmemory", 1000, VarParsing.multiplicity.singleton, VarParsing.varType.int, "Memory budget in MB for output tree baskets of all streams")
 
 options.parseArguments()
 
@@ -36,6 +46,12 @@ process = cms.Process("MiniSkimming")
 process.load("FWCore.MessageService.MessageLogger_cfi")
 process.MessageLogger.cerr.FwkReport.reportEvery = 100
 
+##Each stream gets its own set of analyzers in the skimmer
+process.options = cms.untracked.PSet(
+                    numberOfThreads = cms.untracked.uint32(options.threads),
+                    numberOfStreams = cms.untracked.uint32(0),
+)
+
 ##Load necessary modules
 process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
 process.load('Configuration.StandardSequences.Services_cff')
@@ -93,14 +109,38 @@ process.skimmer = cms.EDAnalyzer("MiniSkimmer",
                                 rho = cms.InputTag("fixedGridRhoFastjetAll"),
                                 vtx = cms.InputTag("offlineSlimmedPrimaryVertices"),
                                 svtx = cms.InputTag("slimmedSecondaryVertices"),
+                                preselection = cms.InputTag("preselector" if options.preselection else ""),
                                 channels = cms.vstring(options.channel[0]),
+                                muTriggers = cms.vstring("HLT_IsoMu27"),
+                                eleTriggers = cms.vstring("HLT_Ele35_WPTight_Gsf", "HLT_Ele28_eta2p1_WPTight_Gsf_HT150", "HLT_Ele30_eta2p1_WPTight_Gsf_CentralPFJet35_EleCleaned"),
                                 xSec = cms.double(xSec),
                                 outFile = cms.string(options.outname),
                                 isData = cms.bool(isData),
+                                autoFlush = cms.int64(options.autoflush),
+                                autoSave = cms.int64(options.autosave),
+                                maxMemory = cms.int32(options.maxmemory//options.threads),
+                                singleTree = cms.bool(options.singletree),
+                                flatOutput = cms.bool(options.flatoutput),
+                                systematics = cms.bool(options.systematics),
+                                performanceReport = cms.bool(options.performancereport),
+                                skipAnalyzers = cms.bool(options.skipanalyzers),
+                )
+
+##Preselection with the input collections, the electrons before the egamma post reco sequence
+process.preselector = cms.EDFilter("MiniPreSelector",
+                                jets = cms.InputTag("slimmedJets"),
+                                fatjets = cms.InputTag("slimmedJetsAK8"),
+                                electrons = cms.InputTag("slimmedElectrons", "", "@skipCurrentProcess"),
+                                muons = cms.InputTag("slimmedMuons"),
+                                trigger = process.skimmer.trigger,
+                                channels = process.skimmer.channels,
+                                muTriggers = process.skimmer.muTriggers,
+                                eleTriggers = process.skimmer.eleTriggers,
+                                isData = cms.bool(isData),
                 )
 
 ##Let it run baby
-process.p = cms.Path(
+process.producers = cms.Sequence(
                      process.patJetCorrFactorsRAW*process.updatedPatJetsRAW*
                      process.patJetCorrFactorsTransientCorrectedRAW*
                      process.pfImpactParameterTagInfosRAW*
@@ -109,6 +149,9 @@ process.p = cms.Path(
                      process.pfDeepFlavourJetTagsRAW*
                      process.updatedPatJetsTransientCorrectedRAW*process.selectedUpdatedPatJetsRAW*
                      process.patJetCorrFactorsAK8RAW*process.updatedPatJetsAK8RAW*
-                     process.egammaPostRecoSeq*
-                     process.skimmer
+                     process.egammaPostRecoSeq
             )
+
+##Skimmer is on the end path, so it also sees events failing the preselection for the event weights
+process.p = cms.Path(process.preselector*process.producers if options.preselection else process.producers)
+process.e = cms.EndPath(process.skimmer)
@@ -15,6 +15,16 @@ def parser():
 
     parser.add_argument("--out-dir", type = str, default = "{}/src".format(os.environ["CMSSW_BASE"]), help = "Name of output directory")    
     parser.add_argument("--out-name", type = str, default = "outputSkim.root", help = "Output name of skimmed file")
+    parser.add_argument("--threads", type = int, default = 1, help = "Number of threads used for the event loop")
+    parser.add_argument("--auto-flush", type = int, default = -30000000, help = "AutoFlush of output trees (negative values in bytes)")
+    parser.add_argument("--auto-save", type = int, default = -300000000, help = "AutoSave of output trees (negative values in bytes)")
+    parser.add_argument("--single-tree", action = "store_true", help = "Write all channels in one tree with channel bitmask")
+    parser.add_argument("--staged-read", action = "store_true", help = "Reject events on raw object counts before reading the object collections")
+    parser.add_argument("--flat-output", action = "store_true", help = "Write NanoAOD like flat branches instead of std::vector branches")
+    parser.add_argument("--systematics", action = "store_true", help = "Write JES/JER variations next to nominal jets")
+    parser.add_argument("--performance-report", action = "store_true", help = "Print timing per analyzer and write JSON report next to the output file")
+    parser.add_argument("--skip-analyzers", action = "store_true", help = "Skip analyzers no remaining channel needs, e.g. electrons in events only passing muon channels (their branches stay empty)")
+    parser.add_argument("--max-memory", type = int, default = 1000, help = "Memory budget in MB for output tree baskets of all threads")
 
     return parser.parse_args()
 
@@ -34,9 +44,16 @@ def main():
     channels = vector("string")()
     [channels.push_back(channel) for channel in args.channel]
 
-    skimmer = NanoSkimmer(args.filename, isData)
+    skimmer = NanoSkimmer(args.filename, args.out_name, isData, args.threads)
+    skimmer.SetOutputOptions(args.auto_flush, args.auto_save, args.max_memory)
+    skimmer.SetSingleTree(args.single_tree)
+    skimmer.SetStagedRead(args.staged_read)
+    skimmer.SetFlatOutput(args.flat_output)
+    skimmer.SetSystematics(args.systematics)
+    skimmer.SetPerformanceReport(args.performance_report)
+    skimmer.SetSkipAnalyzers(args.skip_analyzers)
     skimmer.EventLoop(channels, xSec)
-    skimmer.WriteOutput(args.out_name)
+    skimmer.WriteOutput()
 
 if __name__ == "__main__":
     main()
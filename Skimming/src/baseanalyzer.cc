@@ -3,121 +3,96 @@
 BaseAnalyzer::BaseAnalyzer(): isNANO(false){}
 BaseAnalyzer::BaseAnalyzer(TTreeReader* reader): reader(reader), isNANO(true){}
 
-void BaseAnalyzer::SetCollection(bool &isData){
-    if(!isData){
-        genPt = std::make_unique<TTreeReaderArray<float>>(*reader, "GenPart_pt");
-        genEta = std::make_unique<TTreeReaderArray<float>>(*reader, "GenPart_eta");
-        genPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "GenPart_phi");
-        genMass = std::make_unique<TTreeReaderArray<float>>(*reader, "GenPart_mass");
-        genID = std::make_unique<TTreeReaderArray<int>>(*reader, "GenPart_pdgId");
-        genMotherIdx = std::make_unique<TTreeReaderArray<int>>(*reader, "GenPart_genPartIdxMother");
-        genStatus = std::make_unique<TTreeReaderArray<int>>(*reader, "GenPart_statusFlags");
-        eleGenIdx = std::make_unique<TTreeReaderArray<int>>(*reader, "Electron_genPartIdx");
-        muonGenIdx = std::make_unique<TTreeReaderArray<int>>(*reader, "Muon_genPartIdx");
-    }
-
-    run = std::make_unique<TTreeReaderValue<unsigned int>>(*reader, "run");
-
-    trigObjPt = std::make_unique<TTreeReaderArray<float>>(*reader, "TrigObj_pt");
-    trigObjEta = std::make_unique<TTreeReaderArray<float>>(*reader, "TrigObj_eta");
-    trigObjPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "TrigObj_phi");
-    trigObjID = std::make_unique<TTreeReaderArray<int>>(*reader, "TrigObj_id");
-    trigObjFilterBit = std::make_unique<TTreeReaderArray<int>>(*reader, "TrigObj_filterBits");
+void BaseAnalyzer::SetFlatOutput(const bool &flatOutput){
+    this->flatOutput = flatOutput;
 }
 
+void BaseAnalyzer::SetSystematics(const bool &systematics){
+    this->systematics = systematics;
+}
 
-const reco::Candidate* BaseAnalyzer::LastCopy(const reco::GenParticle& part, const int& pdgID){
-    const reco::Candidate* cand = &part;
+void BaseAnalyzer::SetTriggerObjects(const std::shared_ptr<TriggerObjectIndex> &triggerObjects){
+    this->triggerObjects = triggerObjects;
+}
 
-    while(abs(cand->mother()->pdgId()) == pdgID){
-        cand = cand->mother();
-    }
+void BaseAnalyzer::SetGenealogy(const std::shared_ptr<GenealogyTable> &genealogy){
+    this->genealogy = genealogy;
+}
 
-    return cand;
+void BaseAnalyzer::SetInput(const std::shared_ptr<InputColumns> &input){
+    this->input = input;
 }
 
-const reco::Candidate* BaseAnalyzer::LastCopy(const reco::Candidate* part, const int& pdgID){
-    const reco::Candidate* cand = part;
+unsigned int BaseAnalyzer::ChannelMask(const std::vector<CutFlow> &cutflows) const {
+    unsigned int mask = 0;
 
-    while(abs(cand->mother()->pdgId()) == pdgID){
-        cand = cand->mother();
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        if(IsNeeded(cutflows[i])) mask |= 1 << i;
     }
 
-    return cand;
+    return mask;
 }
 
-int BaseAnalyzer::LastCopy(const int& index, const int& pdgID){
-    int idx = genMotherIdx->At(index);
-
-    while(abs(genID->At(idx)) == pdgID){
-        idx = genMotherIdx->At(idx);
+void BaseAnalyzer::SetCollection(bool &isData){
+    if(!isData){
+        genPt = input->Array<float>("GenPart_pt");
+        genEta = input->Array<float>("GenPart_eta");
+        genPhi = input->Array<float>("GenPart_phi");
+        genMass = input->Array<float>("GenPart_mass");
+        genID = input->Array<int>("GenPart_pdgId");
+        genMotherIdx = input->Array<int>("GenPart_genPartIdxMother");
+        genStatus = input->Array<int>("GenPart_statusFlags");
+        eleGenIdx = input->Array<int>("Electron_genPartIdx");
+        muonGenIdx = input->Array<int>("Muon_genPartIdx");
     }
 
-    return idx; 
+    run = input->Value<unsigned int>("run");
+
+    trigObjPt = input->Array<float>("TrigObj_pt");
+    trigObjEta = input->Array<float>("TrigObj_eta");
+    trigObjPhi = input->Array<float>("TrigObj_phi");
+    trigObjID = input->Array<int>("TrigObj_id");
+    trigObjFilterBit = input->Array<int>("TrigObj_filterBits");
 }
 
-bool BaseAnalyzer::triggerMatching(const TLorentzVector &particle, const std::vector<pat::TriggerObjectStandAlone> trigObj){
-    int size = isNANO ? trigObjEta->GetSize() : trigObj.size();
 
-    for(int i=0; i < size; i++){
-        //Check if trig obj is electron
-        float pt, eta, phi;
+const GenealogyTable& BaseAnalyzer::Genealogy(const std::vector<reco::GenParticle>& genParticle){
+    //First analyzer asking in this event builds the table
+    if(!genealogy->IsBuilt()){
+        if(isNANO) genealogy->Build(genID->View(), genMotherIdx->View());
+        else genealogy->Build(genParticle);
+    }
 
-        pt = isNANO ? trigObjPt->At(i) : trigObj[i].pt();
-        eta = isNANO ? trigObjEta->At(i) : trigObj[i].eta();
-        phi = isNANO ? trigObjPhi->At(i) : trigObj[i].phi();
+    return *genealogy;
+}
 
-        if(0.5 > std::sqrt(std::pow(eta - particle.Eta(), 2) + std::pow(phi - particle.Phi(), 2)) and abs(particle.Pt()-pt)/particle.Pt() < 0.5){
-            return true;
-        }
+bool BaseAnalyzer::triggerMatching(const FourVector &particle, const TriggerObjectIndex::ObjectType &type, const std::vector<pat::TriggerObjectStandAlone> &trigObj){
+    //First analyzer asking in this event builds the index
+    if(!triggerObjects->IsBuilt()){
+        if(isNANO) triggerObjects->Build(trigObjID->View(), trigObjPt->View(), trigObjEta->View(), trigObjPhi->View(), trigObjFilterBit->View());
+        else triggerObjects->Build(trigObj);
     }
 
-    return false;
+    return triggerObjects->Match(type, particle.Pt(), particle.Eta(), particle.Phi());
 }
 
-bool BaseAnalyzer::SetGenParticles(TLorentzVector &validLepton, const int &i, const int &pdgID, const std::vector<reco::GenParticle>& genParticle){
-    const reco::GenParticle* matchedLep=NULL;
+bool BaseAnalyzer::SetGenParticles(const FourVector &validLepton, const int &i, const int &pdgID, const std::vector<reco::GenParticle>& genParticle){
+    int index = -1;
+
+    if(isNANO) index = pdgID == 11 ? eleGenIdx->At(i) : muonGenIdx->At(i);
+
+    else{
+        for(unsigned int j = 0; j < genParticle.size(); j++){
+            const reco::GenParticle &part = genParticle[j];
 
-    if(!isNANO){
-        for(const reco::GenParticle &part: genParticle){
             if(part.isPromptFinalState()){
-                if(0.5 > std::sqrt(std::pow(part.eta() - validLepton.Eta(), 2) + std::pow(part.phi() - validLepton.Phi(), 2)) and abs(validLepton.Pt()-part.pt())/validLepton.Pt() < 0.5){
-                    matchedLep = &part;
+                if(validLepton.DeltaR(part.eta(), part.phi()) < 0.5 and abs(validLepton.Pt()-part.pt())/validLepton.Pt() < 0.5){
+                    index = j;
                 }
             }
         }
     }   
 
-    bool isgenMatched = isNANO ? eleGenIdx->At(i) != -1 : matchedLep!=NULL;
-
-    //Check if gen matched particle exist
-    if(isgenMatched){
-        const reco::Candidate* lepton=NULL;
-        int index=0;
-            
-        if(isNANO) index = LastCopy(pdgID == 11 ? eleGenIdx->At(i) : muonGenIdx->At(i), pdgID);
-        else lepton = LastCopy(*matchedLep, pdgID);
-
-        int motherID = isNANO ? abs(genID->At(genMotherIdx->At(index))) : abs(lepton->mother()->pdgId()); 
-
-        if(motherID == 24){
-            const reco::Candidate* WBoson=NULL;
-            int index=0;
-                
-            if(isNANO) index = LastCopy(eleGenIdx->At(i), 24);
-            else WBoson = LastCopy(lepton->mother(), 24);
-
-            int motherID = isNANO ? abs(genID->At(genMotherIdx->At(index))) : abs(WBoson->mother()->pdgId());     
-
-            if(motherID == 37){
-                return true;
-            }
-
-            return false;
-        }
-
-        return false;
-    }
-
-    return false;
+    //Check if gen matched particle exist and comes from H+ -> W
+    return index != -1 and Genealogy(genParticle).GetOrigin(index) == GenealogyTable::HC_W;
 }
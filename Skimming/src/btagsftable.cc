@@ -0,0 +1,191 @@
+#include <ChargedSkimming/Skimming/interface/btagsftable.h>
+#include <ChargedSkimming/Skimming/interface/calibrationcache.h>
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+    struct CacheHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t nWP;
+        std::uint32_t nEta;
+        std::uint32_t nNodes;
+        float etaMax;
+        float etaStep;
+        float ptStep;
+        std::uint32_t padding;
+    };
+
+    template<typename T>
+    void Append(std::vector<char> &buffer, const std::vector<T> &values){
+        const char* begin = reinterpret_cast<const char*>(values.data());
+        buffer.insert(buffer.end(), begin, begin + values.size()*sizeof(T));
+    }
+
+    template<typename T>
+    void Read(const char* &data, std::vector<T> &values, const std::size_t &n){
+        values.resize(n);
+        std::memcpy(values.data(), data, n*sizeof(T));
+        data += n*sizeof(T);
+    }
+}
+
+BTagSFTable::BTagSFTable(){}
+
+BTagSFTable::BTagSFTable(const std::string &csvFile, const std::string &measurement, const std::vector<BTagEntry::OperatingPoint> &workingPoints, const BTagEntry::JetFlavor &flavor){
+    //Cache is keyed by the CSV content and everything which changes the table
+    std::string key = CalibrationCache::ReadFile(csvFile) + measurement + std::to_string(flavor);
+
+    for(const BTagEntry::OperatingPoint &wp: workingPoints){
+        key += std::to_string(wp);
+    }
+
+    std::string cacheFile = CalibrationCache::Path("btagsftable", CalibrationCache::Checksum(key));
+    CalibrationCache cache(cacheFile);
+
+    if(cache.IsOpen() and Deserialize(cache.Data(), cache.Size())) return;
+
+    //https://twiki.cern.ch/twiki/bin/view/CMS/BTagCalibration
+    BTagCalibration calib("", csvFile);
+
+    Fill(calib, measurement, workingPoints, flavor);
+    CalibrationCache::Write(cacheFile, Serialize());
+}
+
+void BTagSFTable::Fill(const BTagCalibration &calib, const std::string &measurement, const std::vector<BTagEntry::OperatingPoint> &workingPoints, const BTagEntry::JetFlavor &flavor){
+    nWP = workingPoints.size();
+    nEta = std::ceil(etaMax/etaStep);
+
+    for(const BTagEntry::OperatingPoint &wp: workingPoints){
+        BTagCalibrationReader reader(wp, "central", {"up", "down"});
+        reader.load(calib, flavor, measurement);
+
+        for(unsigned int e = 0; e < nEta; e++){
+            float eta = (e + 0.5)*etaStep;
+            std::pair<float, float> bounds = reader.min_max_pt(flavor, eta);
+
+            ptMin.push_back(bounds.first);
+            ptMax.push_back(bounds.second);
+            offsets.push_back(nodePt.size());
+
+            if(bounds.first >= bounds.second) continue;
+
+            //Out of bound nodes, eval_auto_bounds clamps pt and doubles the uncertainty there
+            std::vector<float> pts = {bounds.first, std::nextafter(bounds.second, INFINITY)};
+
+            //Nodes at most ptStep apart in the valid range (ptMin, ptMax]
+            for(float pt = std::nextafter(bounds.first, INFINITY); pt < bounds.second; pt = bounds.first + ptStep*std::floor((pt - bounds.first)/ptStep + 1)){
+                pts.push_back(pt);
+            }
+
+            pts.push_back(bounds.second);
+
+            //Both sides of the pt bin edges of all variations, a jet between two neighbouring floats does not exist
+            for(const char* variation: {"central", "up", "down"}){
+                for(const BTagEntry &entry: calib.getEntries(BTagEntry::Parameters(wp, measurement, variation))){
+                    if(entry.params.jetFlavor != flavor or eta < entry.params.etaMin or eta > entry.params.etaMax) continue;
+
+                    for(const float &edge: {entry.params.ptMin, entry.params.ptMax}){
+                        if(edge <= bounds.first or edge > bounds.second) continue;
+
+                        pts.insert(pts.end(), {std::nextafter(edge, -INFINITY), edge, std::nextafter(edge, INFINITY)});
+                    }
+                }
+            }
+
+            std::sort(pts.begin(), pts.end());
+            pts.erase(std::unique(pts.begin(), pts.end()), pts.end());
+
+            for(const float &pt: pts){
+                nodePt.push_back(pt);
+
+                for(const char* variation: {"central", "up", "down"}){
+                    nodeValues.push_back(reader.eval_auto_bounds(variation, flavor, eta, pt));
+                }
+            }
+        }
+    }
+
+    offsets.push_back(nodePt.size());
+}
+
+std::vector<char> BTagSFTable::Serialize() const {
+    CacheHeader header = {{'B', 'T', 'A', 'G', 'S', 'F', 'T', 'B'}, CalibrationCache::version, nWP, nEta, (std::uint32_t)nodePt.size(), etaMax, etaStep, ptStep, 0};
+
+    std::vector<char> buffer(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(header));
+    Append(buffer, ptMin);
+    Append(buffer, ptMax);
+    Append(buffer, offsets);
+    Append(buffer, nodePt);
+    Append(buffer, nodeValues);
+
+    return buffer;
+}
+
+bool BTagSFTable::Deserialize(const char* data, const std::size_t &size){
+    if(size < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if(std::string(header.magic, 8) != "BTAGSFTB" or header.version != CalibrationCache::version) return false;
+
+    std::size_t nCells = header.nWP*header.nEta;
+    if(size != sizeof(header) + 4*(3*nCells + 1 + 4*header.nNodes)) return false;
+
+    nWP = header.nWP;
+    nEta = header.nEta;
+    etaMax = header.etaMax;
+    etaStep = header.etaStep;
+    ptStep = header.ptStep;
+
+    data += sizeof(header);
+    Read(data, ptMin, nCells);
+    Read(data, ptMax, nCells);
+    Read(data, offsets, nCells + 1);
+    Read(data, nodePt, header.nNodes);
+    Read(data, nodeValues, 3*header.nNodes);
+
+    return true;
+}
+
+float BTagSFTable::Evaluate(const unsigned int &wp, const Variation &variation, const float &absEta, const float &pt) const {
+    //No SF outside of the eta range of the file, as in BTagCalibrationReader
+    if(wp >= nWP or absEta < 0 or absEta >= etaMax) return 0.;
+
+    unsigned int cell = wp*nEta + std::min((unsigned int)(absEta/etaStep), nEta - 1);
+    if(ptMin[cell] >= ptMax[cell]) return 0.;
+
+    //Out of bound jets get the values of the outermost nodes, as in eval_auto_bounds
+    const float* first = &nodePt[offsets[cell]];
+    const float* last = &nodePt[offsets[cell + 1] - 1];
+
+    if(pt <= *first) return nodeValues[3*offsets[cell] + variation];
+    if(pt >= *last) return nodeValues[3*(offsets[cell + 1] - 1) + variation];
+
+    //Interpolate between the nodes around pt, which always belong to the same pt bin
+    unsigned int k = std::upper_bound(first, last, pt) - first - 1;
+    const float* low = &nodeValues[3*(offsets[cell] + k)];
+    const float* high = low + 3;
+
+    float t = (pt - first[k])/(first[k + 1] - first[k]);
+
+    return low[variation] + t*(high[variation] - low[variation]);
+}
+
+void BTagSFTable::Evaluate(const std::vector<float> &absEta, const std::vector<float> &pt, std::vector<std::vector<float>> &values) const {
+    values.resize(3*nWP);
+
+    for(unsigned int wp = 0; wp < nWP; wp++){
+        for(const Variation &variation: {CENTRAL, UP, DOWN}){
+            std::vector<float> &column = values[3*wp + variation];
+            column.resize(pt.size());
+
+            for(unsigned int j = 0; j < pt.size(); j++){
+                column[j] = Evaluate(wp, variation, absEta[j], pt[j]);
+            }
+        }
+    }
+}
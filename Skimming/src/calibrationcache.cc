@@ -0,0 +1,104 @@
+#include <ChargedSkimming/Skimming/interface/calibrationcache.h>
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+CalibrationCache::CalibrationCache(const std::string &path){
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) return;
+
+    struct stat info;
+
+    if(fstat(fd, &info) == 0 and info.st_size > 0){
+        void* mapped = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if(mapped != MAP_FAILED){
+            data = static_cast<const char*>(mapped);
+            size = info.st_size;
+        }
+    }
+
+    //Mapping stays valid after closing the file descriptor
+    close(fd);
+}
+
+CalibrationCache::~CalibrationCache(){
+    if(data != NULL) munmap(const_cast<char*>(data), size);
+}
+
+bool CalibrationCache::IsOpen() const {
+    return data != NULL;
+}
+
+const char* CalibrationCache::Data() const {
+    return data;
+}
+
+std::size_t CalibrationCache::Size() const {
+    return size;
+}
+
+std::string CalibrationCache::Directory(){
+    for(const char* name: {"CHARGEDSKIM_CACHE", "TMPDIR"}){
+        const char* dir = std::getenv(name);
+        if(dir != NULL and dir[0] != '\0') return dir;
+    }
+
+    return "/tmp";
+}
+
+std::string CalibrationCache::Path(const std::string &prefix, const std::uint64_t &checksum){
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)checksum);
+
+    return Directory() + "/" + prefix + "_" + hash + "_v" + std::to_string(version) + ".bin";
+}
+
+std::uint64_t CalibrationCache::Checksum(const std::string &content){
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for(const char &c: content){
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+std::string CalibrationCache::ReadFile(const std::string &fileName){
+    std::ifstream file(fileName, std::ios::binary);
+
+    if(!file.is_open()){
+        throw std::runtime_error("Can not open calibration file: " + fileName);
+    }
+
+    std::ostringstream content;
+    content << file.rdbuf();
+
+    return content.str();
+}
+
+bool CalibrationCache::Write(const std::string &path, const std::vector<char> &buffer){
+    std::string tmpPath = path + "." + std::to_string(getpid()) + ".tmp";
+
+    std::ofstream file(tmpPath, std::ios::binary);
+    if(!file.is_open()) return false;
+
+    file.write(buffer.data(), buffer.size());
+    file.close();
+
+    if(!file or std::rename(tmpPath.c_str(), path.c_str()) != 0){
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
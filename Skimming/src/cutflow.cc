@@ -0,0 +1,74 @@
+#include <ChargedSkimming/Skimming/interface/cutflow.h>
+
+#include <cmath>
+#include <algorithm>
+#include <map>
+
+#include <TH1F.h>
+
+std::vector<CutFlow> CutFlow::Channels(const std::vector<std::string> &channels){
+    //Minimal number of muons, electrons, jets and fat jets
+    static const std::map<std::string, std::vector<unsigned int>> nMin = {
+            {"mu4j", {1, 0, 4, 0}},
+            {"e4j", {0, 1, 4, 0}},
+            {"mu2j1f", {1, 0, 2, 1}},
+            {"e2j1f", {0, 1, 2, 1}},
+            {"mu2f", {1, 0, 0, 2}},
+            {"e2f", {0, 1, 0, 2}},
+    };
+
+    std::vector<CutFlow> cutflows;
+
+    for(const std::string &channel: channels){
+        //Cut steps are registered by the analyzers
+        CutFlow cutflow;
+
+        cutflow.channel = channel;
+
+        cutflow.nMinMu=nMin.at(channel)[0];
+        cutflow.nMinEle=nMin.at(channel)[1];
+        cutflow.nMinJet=nMin.at(channel)[2];
+        cutflow.nMinFatjet=nMin.at(channel)[3];
+
+        cutflows.push_back(cutflow);
+    }
+
+    return cutflows;
+}
+
+unsigned int CutFlow::AddStep(const std::string &label){
+    std::vector<std::string>::iterator it = std::find(steps.begin(), steps.end(), label);
+    if(it != steps.end()) return it - steps.begin();
+
+    steps.push_back(label);
+    sumW.push_back(0.);
+    sumW2.push_back(0.);
+
+    return steps.size() - 1;
+}
+
+void CutFlow::Merge(const CutFlow &other){
+    for(unsigned int i = 0; i < other.steps.size(); i++){
+        unsigned int step = AddStep(other.steps[i]);
+
+        sumW[step] += other.sumW[i];
+        sumW2[step] += other.sumW2[i];
+    }
+
+    nEntries += other.nEntries;
+}
+
+void CutFlow::Write() const {
+    TH1F* hist = new TH1F(("cutflow_" + channel).c_str(), "", steps.size(), 0, steps.size());
+    hist->GetYaxis()->SetName("Events");
+
+    for(unsigned int i = 0; i < steps.size(); i++){
+        hist->GetXaxis()->SetBinLabel(i + 1, steps[i].c_str());
+        hist->SetBinContent(i + 1, sumW[i]);
+        hist->SetBinError(i + 1, std::sqrt(sumW2[i]));
+    }
+
+    hist->SetEntries(nEntries);
+    hist->Write();
+    delete hist;
+}
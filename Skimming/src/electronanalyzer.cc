@@ -1,13 +1,10 @@
 #include <ChargedSkimming/Skimming/interface/electronanalyzer.h>
 
-ElectronAnalyzer::ElectronAnalyzer(const int &era, const float &ptCut, const float &etaCut, eToken& eleToken, trigObjToken& triggerObjToken, genPartToken& genParticleToken):
+ElectronAnalyzer::ElectronAnalyzer(const int &era, const float &ptCut, const float &etaCut):
     BaseAnalyzer(),    
     era(era),
     ptCut(ptCut),
-    etaCut(etaCut),
-    eleToken(eleToken),
-    triggerObjToken(triggerObjToken),
-    genParticleToken(genParticleToken)
+    etaCut(etaCut)
     {}
 
 ElectronAnalyzer::ElectronAnalyzer(const int &era, const float &ptCut, const float &etaCut, TTreeReader& reader):
@@ -17,7 +14,7 @@ ElectronAnalyzer::ElectronAnalyzer(const int &era, const float &ptCut, const flo
     etaCut(etaCut)
     {}
 
-void ElectronAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
+void ElectronAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
     //SF files
     mediumSFfiles = {
                     {2017, filePath + "eleSF/gammaEffi.txt_EGM2D_runBCDEF_passingMVA94Xwp80iso.root"},
@@ -34,25 +31,20 @@ void ElectronAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     //Set data bool
     this->isData = isData;
 
-    //Hist with scale factors
-    TFile* recoSFfile = TFile::Open(recoSFfiles[era].c_str());
-    recoSFhist = (TH2F*)recoSFfile->Get("EGamma_SF2D");
-
-    TFile* mediumSFfile = TFile::Open(mediumSFfiles[era].c_str());
-    mediumSFhist = (TH2F*)mediumSFfile->Get("EGamma_SF2D");
-
-    TFile* tightSFfile = TFile::Open(tightSFfiles[era].c_str());
-    tightSFhist = (TH2F*)tightSFfile->Get("EGamma_SF2D");
+    //Scale factors, files are closed after copying the histograms
+    recoSF = ScaleFactorTable(recoSFfiles[era], "EGamma_SF2D");
+    mediumSF = ScaleFactorTable(mediumSFfiles[era], "EGamma_SF2D");
+    tightSF = ScaleFactorTable(tightSFfiles[era], "EGamma_SF2D");
 
     //Initiliaze TTreeReaderValues then using NANO AOD
     if(isNANO){
-        elePt = std::make_unique<TTreeReaderArray<float>>(*reader, "Electron_pt");
-        eleEta = std::make_unique<TTreeReaderArray<float>>(*reader, "Electron_eta");
-        elePhi = std::make_unique<TTreeReaderArray<float>>(*reader, "Electron_phi");
-        eleCharge = std::make_unique<TTreeReaderArray<int>>(*reader, "Electron_charge");
-        eleIso = std::make_unique<TTreeReaderArray<float>>(*reader, "Electron_pfRelIso03_all");
-        eleMediumMVA = std::make_unique<TTreeReaderArray<bool>>(*reader, "Electron_mvaFall17Iso_WP80");
-        eleTightMVA = std::make_unique<TTreeReaderArray<bool>>(*reader, "Electron_mvaFall17Iso_WP80");
+        elePt = input->Array<float>("Electron_pt");
+        eleEta = input->Array<float>("Electron_eta");
+        elePhi = input->Array<float>("Electron_phi");
+        eleCharge = input->Array<int>("Electron_charge");
+        eleIso = input->Array<float>("Electron_pfRelIso03_all");
+        eleMediumMVA = input->Array<bool>("Electron_mvaFall17Iso_WP80");
+        eleTightMVA = input->Array<bool>("Electron_mvaFall17Iso_WP80");
 
         //Set TTreeReader for genpart and trigger obj from baseanalyzer    
         SetCollection(this->isData);
@@ -62,22 +54,38 @@ void ElectronAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     floatNames = {"E", "Px", "Py", "Pz", "Isolation", "Charge", "mediumSF", "tightSF", "recoSF"};
     boolNames = { "isMedium", "isTight", "isTriggerMatched", "isFromHc"};
 
+    //Uncertainties of the scale factors
+    if(systematics and !this->isData){
+        floatNames.insert(floatNames.end(), {"mediumSFUnc", "tightSFUnc", "recoSFUnc"});
+    }
+
     floatVariables = std::vector<std::vector<float>>(floatNames.size(), std::vector<float>());
     boolVariables = std::vector<std::vector<bool>>(boolNames.size(), std::vector<bool>());
 
     //Set Branches of output tree
-    for(TTree* tree: trees){
-        for(unsigned int i=0; i<floatVariables.size(); i++){
-            tree->Branch(("Electron_" + floatNames[i]).c_str(), &floatVariables[i]);
-        }
+    if(flatOutput){
+        electronCollection = FlatCollection("Electron", floatNames, boolNames);
+        electronCollection.Branch(trees);
+    }
 
-        for(unsigned int i=0; i<boolVariables.size(); i++){
-            tree->Branch(("Electron_" + boolNames[i]).c_str(), &boolVariables[i]);
+    else{
+        for(TTree* tree: trees){
+            for(unsigned int i=0; i<floatVariables.size(); i++){
+                tree->Branch(("Electron_" + floatNames[i]).c_str(), &floatVariables[i]);
+            }
+
+            for(unsigned int i=0; i<boolVariables.size(); i++){
+                tree->Branch(("Electron_" + boolNames[i]).c_str(), &boolVariables[i]);
+            }
         }
     }
+
+    for(CutFlow &cutflow: cutflows){
+        cutSteps.push_back(cutflow.nMinEle!=0 ? cutflow.AddStep("N_{e} >= " + std::to_string(cutflow.nMinEle) + " (no iso/ID req)") : 0);
+    }
 }
 
-void ElectronAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
+void ElectronAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     //Clear variables vector
     for(std::vector<float>& variable: floatVariables){
         variable.clear();
@@ -93,8 +101,9 @@ void ElectronAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event*
     edm::Handle<std::vector<reco::GenParticle>> genParts;
 
     if(!isNANO){
-        event->getByToken(eleToken, electrons);
-        event->getByToken(triggerObjToken, trigObjects);
+        electrons = context->Electrons();
+        trigObjects = context->TriggerObjects();
+        if(!isData) genParts = context->GenParticles();
     }
 
     float eleSize = isNANO ? elePt->GetSize() : electrons->size();
@@ -106,8 +115,7 @@ void ElectronAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event*
         float phi = isNANO ? elePhi->At(i) : (electrons->at(i).p4()*electrons->at(i).userFloat("ecalTrkEnergyPostCorr") / electrons->at(i).energy()).Phi();
 
         if(pt > ptCut && abs(eta) < etaCut){
-            TLorentzVector lVec;
-            lVec.SetPtEtaPhiM(pt, eta, phi, 0.510*1e-3);
+            FourVector lVec = FourVector::PtEtaPhiM(pt, eta, phi, 0.510*1e-3);
 
             //Electron four momentum components
             floatVariables[0].push_back(lVec.E());   //Energy
@@ -128,40 +136,62 @@ void ElectronAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event*
             //Electron ID
             boolVariables[0].push_back(isNANO ? eleMediumMVA->At(i) : electrons->at(i).electronID("mvaEleID-Fall17-iso-V2-wp80"));  //Medium MVA ID
             boolVariables[1].push_back(isNANO ? eleMediumMVA->At(i) : electrons->at(i).electronID("mvaEleID-Fall17-iso-V2-wp90"));  //Tight MVA ID
-            boolVariables[2].push_back(isNANO ? triggerMatching(lVec) : triggerMatching(lVec, *trigObjects)); //Trigger matching
+            boolVariables[2].push_back(isNANO ? triggerMatching(lVec, TriggerObjectIndex::EGAMMA) : triggerMatching(lVec, TriggerObjectIndex::EGAMMA, *trigObjects)); //Trigger matching
 
             if(!isData){
                //Fill scale factors
-                floatVariables[6].push_back(recoSFhist->GetBinContent(recoSFhist->FindBin(eta, pt)));
-                floatVariables[7].push_back(mediumSFhist->GetBinContent(mediumSFhist->FindBin(eta, pt)));
-                floatVariables[8].push_back(tightSFhist->GetBinContent(tightSFhist->FindBin(eta, pt)));
+                ScaleFactorTable::ScaleFactor medium = mediumSF.Get(eta, pt);
+                ScaleFactorTable::ScaleFactor tight = tightSF.Get(eta, pt);
+                ScaleFactorTable::ScaleFactor reco = recoSF.Get(eta, pt);
+
+                floatVariables[6].push_back(medium.value);
+                floatVariables[7].push_back(tight.value);
+                floatVariables[8].push_back(reco.value);
+
+                if(systematics){
+                    floatVariables[9].push_back(medium.error);
+                    floatVariables[10].push_back(tight.error);
+                    floatVariables[11].push_back(reco.error);
+                }
 
                 //Save gen particle information
                 if(isNANO) boolVariables[3].push_back(SetGenParticles(lVec, i, 11));
-                else{
-                    event->getByToken(genParticleToken, genParts);
-                    boolVariables[3].push_back(SetGenParticles(lVec, i, 11, *genParts));
-                }
+                else boolVariables[3].push_back(SetGenParticles(lVec, i, 11, *genParts));
             }
 
             //Fill electron in collection
         } 
     }
 
-    for(CutFlow &cutflow: cutflows){
+    if(flatOutput) electronCollection.Fill(floatVariables, boolVariables);
+
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        CutFlow &cutflow = cutflows[i];
+
         if(cutflow.nMinEle <= floatVariables[0].size()){
             if(cutflow.nMinEle!=0 and cutflow.passed){
-                std::string cutName("N_{e} >= " + std::to_string(cutflow.nMinEle) + " (no iso/ID req)");
-                cutflow.hist->Fill(cutName.c_str(), cutflow.weight);
+                cutflow.Fill(cutSteps[i]);
             }
         }
 
         else{
-            cutflow.passed = false;
+            cutflow.Reject();
         }
     }
 }
 
 
+void ElectronAnalyzer::Clear(){
+    for(std::vector<float>& variable: floatVariables){
+        variable.clear();
+    }
+
+    for(std::vector<bool>& variable: boolVariables){
+        variable.clear();
+    }
+
+    if(flatOutput) electronCollection.Fill(floatVariables, boolVariables);
+}
+
 void ElectronAnalyzer::EndJob(TFile* file){
 }
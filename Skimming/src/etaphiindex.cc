@@ -0,0 +1,113 @@
+#include <ChargedSkimming/Skimming/interface/etaphiindex.h>
+#include <ChargedSkimming/Skimming/interface/fourvector.h>
+
+#include <cmath>
+#include <tuple>
+#include <algorithm>
+
+EtaPhiIndex::EtaPhiIndex(const float &cellSize):
+    cellSize(cellSize),
+    nEta(std::ceil(2*etaMax/cellSize)),
+    nPhi(std::max(1, int(2*M_PI/cellSize))){}
+
+int EtaPhiIndex::EtaCell(const float &eta) const {
+    return std::min(std::max(int((eta + etaMax)/cellSize), 0), nEta - 1);
+}
+
+int EtaPhiIndex::PhiCell(const float &phi) const {
+    //Cells are slightly larger than cellSize, so that they exactly cover 2pi
+    float shifted = phi + M_PI - 2*M_PI*std::floor((phi + M_PI)/(2*M_PI));
+
+    return std::min(int(shifted/(2*M_PI)*nPhi), nPhi - 1);
+}
+
+void EtaPhiIndex::Build(const std::vector<float> &eta, const std::vector<float> &phi){
+    etas = eta;
+    phis = phi;
+
+    //Counting sort of the objects by cell
+    cellStart.assign(nEta*nPhi + 1, 0);
+    entries.resize(eta.size());
+
+    std::vector<unsigned int> cells(eta.size());
+
+    for(unsigned int i = 0; i < eta.size(); i++){
+        cells[i] = EtaCell(eta[i])*nPhi + PhiCell(phi[i]);
+        cellStart[cells[i] + 1]++;
+    }
+
+    for(unsigned int c = 0; c < cellStart.size() - 1; c++){
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    std::vector<unsigned int> position(cellStart.begin(), cellStart.end() - 1);
+
+    for(unsigned int i = 0; i < eta.size(); i++){
+        entries[position[cells[i]]++] = i;
+    }
+}
+
+void EtaPhiIndex::Candidates(const float &eta, const float &phi, const float &radius, std::vector<unsigned int> &indices) const {
+    indices.clear();
+    if(etas.empty()) return;
+
+    //Number of neighbour cells to look at, phi cells are at least cellSize wide
+    int nCells = std::ceil(radius/cellSize);
+    int etaCell = EtaCell(eta), phiCell = PhiCell(phi);
+
+    //Visit each phi cell only once if the radius covers all of them
+    int phiFirst = 2*nCells + 1 >= nPhi ? 0 : phiCell - nCells;
+    int phiLast = 2*nCells + 1 >= nPhi ? nPhi - 1 : phiCell + nCells;
+
+    for(int e = std::max(etaCell - nCells, 0); e <= std::min(etaCell + nCells, nEta - 1); e++){
+        for(int p = phiFirst; p <= phiLast; p++){
+            int cell = e*nPhi + (p + nPhi) % nPhi;
+
+            for(unsigned int k = cellStart[cell]; k < cellStart[cell + 1]; k++){
+                unsigned int i = entries[k];
+
+                if(DeltaR(eta, phi, etas[i], phis[i]) < radius) indices.push_back(i);
+            }
+        }
+    }
+
+    std::sort(indices.begin(), indices.end());
+}
+
+void EtaPhiIndex::Match(const std::vector<float> &eta, const std::vector<float> &phi, const float &radius, std::vector<int> &matches, const std::function<bool(const unsigned int&, const unsigned int&)> &accept) const {
+    matches.assign(eta.size(), -1);
+
+    //All pairs within radius, sorted by dR
+    std::vector<std::tuple<float, unsigned int, unsigned int>> pairs;
+    std::vector<unsigned int> indices;
+
+    for(unsigned int i = 0; i < eta.size(); i++){
+        Candidates(eta[i], phi[i], radius, indices);
+
+        for(const unsigned int &j: indices){
+            if(accept and !accept(i, j)) continue;
+
+            pairs.push_back({DeltaR(eta[i], phi[i], etas[j], phis[j]), i, j});
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+
+    //Greedy best match, each indexed object is used once
+    std::vector<bool> used(etas.size(), false);
+
+    for(const std::tuple<float, unsigned int, unsigned int> &pair: pairs){
+        unsigned int i = std::get<1>(pair), j = std::get<2>(pair);
+
+        if(matches[i] == -1 and !used[j]){
+            matches[i] = j;
+            used[j] = true;
+        }
+    }
+}
+
+float EtaPhiIndex::DeltaR(const float &eta1, const float &phi1, const float &eta2, const float &phi2){
+    float dPhi = FourVector::DeltaPhi(phi1, phi2);
+
+    return std::sqrt((eta1 - eta2)*(eta1 - eta2) + dPhi*dPhi);
+}
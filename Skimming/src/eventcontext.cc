@@ -0,0 +1,31 @@
+#include <ChargedSkimming/Skimming/interface/eventcontext.h>
+
+EventContext::EventContext(){}
+
+EventContext::EventContext(const EventTokens &tokens):
+    tokens(tokens){}
+
+void EventContext::SetEvent(const edm::Event &event){
+    this->event = &event;
+    products = Products();
+}
+
+unsigned int EventContext::Run() const {
+    return event->eventAuxiliary().id().run();
+}
+
+unsigned int EventContext::LumiBlock() const {
+    return event->eventAuxiliary().id().luminosityBlock();
+}
+
+unsigned long long EventContext::EventNumber() const {
+    return event->eventAuxiliary().id().event();
+}
+
+const edm::TriggerNames& EventContext::TriggerNames(){
+    if(products.triggerNames == NULL){
+        products.triggerNames = &event->triggerNames(*Triggers());
+    }
+
+    return *products.triggerNames;
+}
@@ -0,0 +1,117 @@
+#include <ChargedSkimming/Skimming/interface/flatcollection.h>
+
+#include <algorithm>
+
+FlatCollection::FlatCollection(){}
+
+FlatCollection::FlatCollection(const std::string &name, const std::vector<std::string> &floatNames, const std::vector<std::string> &boolNames, const std::vector<std::string> &shortNames):
+    name(name),
+    floatNames(floatNames),
+    boolNames(boolNames){
+
+    for(const std::string &floatName: floatNames){
+        isShort.push_back(std::find(shortNames.begin(), shortNames.end(), floatName) != shortNames.end());
+    }
+
+    floatBuffer = std::vector<std::vector<Float_t>>(floatNames.size());
+    shortBuffer = std::vector<std::vector<Short_t>>(floatNames.size());
+    flagBuffer = std::vector<std::vector<UChar_t>>((boolNames.size() + 7)/8);
+
+    Reserve(16);
+}
+
+std::string FlatCollection::FlagName(const unsigned int &index){
+    return name + "_flags" + (index == 0 ? "" : std::to_string(index));
+}
+
+void FlatCollection::Reserve(const unsigned int &size){
+    if(size <= capacity) return;
+
+    capacity = std::max(size, 2*capacity);
+
+    for(unsigned int i = 0; i < floatNames.size(); i++){
+        if(isShort[i]) shortBuffer[i].resize(capacity);
+        else floatBuffer[i].resize(capacity);
+    }
+
+    for(std::vector<UChar_t> &flags: flagBuffer){
+        flags.resize(capacity);
+    }
+
+    SetAddresses();
+}
+
+void FlatCollection::SetAddresses(){
+    for(TTree* tree: trees){
+        for(unsigned int i = 0; i < floatNames.size(); i++){
+            std::string branchName = name + "_" + floatNames[i];
+
+            if(isShort[i]) tree->SetBranchAddress(branchName.c_str(), shortBuffer[i].data());
+            else tree->SetBranchAddress(branchName.c_str(), floatBuffer[i].data());
+        }
+
+        for(unsigned int i = 0; i < flagBuffer.size(); i++){
+            tree->SetBranchAddress(FlagName(i).c_str(), flagBuffer[i].data());
+        }
+    }
+}
+
+void FlatCollection::Branch(std::vector<TTree*> &trees){
+    std::string counter = "n" + name;
+
+    for(TTree* tree: trees){
+        tree->Branch(counter.c_str(), &nObjects, (counter + "/i").c_str());
+
+        for(unsigned int i = 0; i < floatNames.size(); i++){
+            std::string branchName = name + "_" + floatNames[i];
+
+            if(isShort[i]) tree->Branch(branchName.c_str(), shortBuffer[i].data(), (branchName + "[" + counter + "]/S").c_str());
+            else tree->Branch(branchName.c_str(), floatBuffer[i].data(), (branchName + "[" + counter + "]/F").c_str());
+        }
+
+        for(unsigned int i = 0; i < flagBuffer.size(); i++){
+            tree->Branch(FlagName(i).c_str(), flagBuffer[i].data(), (FlagName(i) + "[" + counter + "]/b").c_str());
+        }
+
+        //Keep old bool names usable in TTree::Draw
+        for(unsigned int i = 0; i < boolNames.size(); i++){
+            tree->SetAlias((name + "_" + boolNames[i]).c_str(), ("(" + FlagName(i/8) + " & " + std::to_string(1 << i%8) + ") != 0").c_str());
+        }
+
+        this->trees.push_back(tree);
+    }
+}
+
+void FlatCollection::Fill(const std::vector<std::vector<float>> &floatVariables, const std::vector<std::vector<bool>> &boolVariables){
+    //Number of objects is given by longest column
+    nObjects = 0;
+
+    for(const std::vector<float> &variable: floatVariables){
+        nObjects = std::max(nObjects, UInt_t(variable.size()));
+    }
+
+    for(const std::vector<bool> &variable: boolVariables){
+        nObjects = std::max(nObjects, UInt_t(variable.size()));
+    }
+
+    Reserve(nObjects);
+
+    for(unsigned int i = 0; i < floatNames.size(); i++){
+        for(unsigned int j = 0; j < nObjects; j++){
+            float value = j < floatVariables[i].size() ? floatVariables[i][j] : -999.;
+
+            if(isShort[i]) shortBuffer[i][j] = value;
+            else floatBuffer[i][j] = value;
+        }
+    }
+
+    for(unsigned int i = 0; i < flagBuffer.size(); i++){
+        std::fill(flagBuffer[i].begin(), flagBuffer[i].begin() + nObjects, 0);
+    }
+
+    for(unsigned int i = 0; i < boolVariables.size(); i++){
+        for(unsigned int j = 0; j < boolVariables[i].size(); j++){
+            if(boolVariables[i][j]) flagBuffer[i/8][j] |= 1 << i%8;
+        }
+    }
+}
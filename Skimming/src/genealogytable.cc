@@ -0,0 +1,135 @@
+#include <ChargedSkimming/Skimming/interface/genealogytable.h>
+
+#include <cstdlib>
+
+void GenealogyTable::Clear(){
+    isBuilt = false;
+}
+
+bool GenealogyTable::IsBuilt() const {
+    return isBuilt;
+}
+
+void GenealogyTable::Build(const ColumnView<int> &pdgID, const ColumnView<int> &motherIdx){
+    pdgIDs.resize(pdgID.GetSize());
+    mothers.resize(pdgID.GetSize());
+
+    for(unsigned int i = 0; i < pdgID.GetSize(); i++){
+        pdgIDs[i] = std::abs(pdgID.At(i));
+        mothers[i] = motherIdx.At(i);
+    }
+
+    Resolve();
+}
+
+void GenealogyTable::Build(const std::vector<reco::GenParticle> &genParticles){
+    candidateIndex.clear();
+
+    for(unsigned int i = 0; i < genParticles.size(); i++){
+        candidateIndex[&genParticles[i]] = i;
+    }
+
+    pdgIDs.resize(genParticles.size());
+    mothers.resize(genParticles.size());
+
+    for(unsigned int i = 0; i < genParticles.size(); i++){
+        pdgIDs[i] = std::abs(genParticles[i].pdgId());
+        mothers[i] = genParticles[i].numberOfMothers() != 0 ? Index(genParticles[i].mother()) : -1;
+    }
+
+    Resolve();
+}
+
+void GenealogyTable::Resolve(){
+    int size = pdgIDs.size();
+
+    //Mother indices outside of the collection (e.g. -1 in NANO) mean no mother
+    for(int &mother: mothers){
+        if(mother < 0 or mother >= size) mother = -1;
+    }
+
+    //Walk up each chain only until a particle with known first copy is reached
+    firstCopies.assign(size, -1);
+    depths.assign(size, 0);
+    std::vector<int> path;
+
+    for(int i = 0; i < size; i++){
+        int j = i;
+        path.clear();
+
+        while(firstCopies[j] == -1 and mothers[j] != -1 and pdgIDs[mothers[j]] == pdgIDs[j] and (int)path.size() < size){
+            path.push_back(j);
+            j = mothers[j];
+        }
+
+        if(firstCopies[j] == -1) firstCopies[j] = j;
+
+        for(unsigned int k = 0; k < path.size(); k++){
+            firstCopies[path[k]] = firstCopies[j];
+            depths[path[k]] = depths[j] + path.size() - k;
+        }
+    }
+
+    //Deepest particle of each chain is its last copy
+    std::vector<int> deepest(size, -1);
+
+    for(int i = 0; i < size; i++){
+        int &last = deepest[firstCopies[i]];
+        if(last == -1 or depths[i] > depths[last]) last = i;
+    }
+
+    lastCopies.resize(size);
+    ancestors.resize(size);
+    ancestorIDs.resize(size);
+    origins.resize(size);
+
+    for(int i = 0; i < size; i++){
+        lastCopies[i] = deepest[firstCopies[i]];
+        ancestors[i] = mothers[firstCopies[i]];
+        ancestorIDs[i] = ancestors[i] != -1 ? pdgIDs[ancestors[i]] : 0;
+    }
+
+    for(int i = 0; i < size; i++){
+        int grandAncestorID = ancestors[i] != -1 ? ancestorIDs[ancestors[i]] : 0;
+
+        if(ancestorIDs[i] == 24 and grandAncestorID == 37) origins[i] = HC_W;
+        else if(ancestorIDs[i] == 25) origins[i] = grandAncestorID == 37 ? HC_H : H;
+        else origins[i] = NONE;
+    }
+
+    isBuilt = true;
+}
+
+unsigned int GenealogyTable::Size() const {
+    return pdgIDs.size();
+}
+
+int GenealogyTable::PdgID(const int &i) const {
+    return pdgIDs[i];
+}
+
+int GenealogyTable::FirstCopy(const int &i) const {
+    return firstCopies[i];
+}
+
+int GenealogyTable::LastCopy(const int &i) const {
+    return lastCopies[i];
+}
+
+int GenealogyTable::Ancestor(const int &i) const {
+    return ancestors[i];
+}
+
+int GenealogyTable::AncestorID(const int &i) const {
+    return ancestorIDs[i];
+}
+
+GenealogyTable::Origin GenealogyTable::GetOrigin(const int &i) const {
+    return origins[i];
+}
+
+int GenealogyTable::Index(const reco::Candidate* candidate) const {
+    std::unordered_map<const reco::Candidate*, int>::const_iterator it = candidateIndex.find(candidate);
+
+    return it != candidateIndex.end() ? it->second : -1;
+}
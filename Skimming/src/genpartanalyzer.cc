@@ -1,14 +1,12 @@
 #include <ChargedSkimming/Skimming/interface/genpartanalyzer.h>
 
-GenPartAnalyzer::GenPartAnalyzer(genPartToken& genParticleToken):
-    BaseAnalyzer(),
-    genParticleToken(genParticleToken)
-    {}
+GenPartAnalyzer::GenPartAnalyzer():
+    BaseAnalyzer(){}
 
 GenPartAnalyzer::GenPartAnalyzer(TTreeReader& reader):
     BaseAnalyzer(&reader){}
 
-void GenPartAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
+void GenPartAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
     //Set data bool
     this->isData = isData;
     
@@ -21,23 +19,35 @@ void GenPartAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     h2Variables = std::vector<std::vector<float>>(floatNames.size(), std::vector<float>());
 
     //Set Branches of output tree
-    for(TTree* tree: trees){
-        for(unsigned int i=0; i<floatNames.size(); i++){
-            tree->Branch(("GenLepton_" + floatNames[i]).c_str(), &leptonVariables[i]);
-        }
+    if(flatOutput){
+        leptonCollection = FlatCollection("GenLepton", floatNames);
+        h1Collection = FlatCollection("GenPartFromh1", floatNames);
+        h2Collection = FlatCollection("GenPartFromh2", floatNames);
 
-        for(unsigned int i=0; i<floatNames.size(); i++){
-            tree->Branch(("GenPartFromh1_" + floatNames[i]).c_str(), &h1Variables[i]);
+        for(FlatCollection* collection: {&leptonCollection, &h1Collection, &h2Collection}){
+            collection->Branch(trees);
         }
+    }
+
+    else{
+        for(TTree* tree: trees){
+            for(unsigned int i=0; i<floatNames.size(); i++){
+                tree->Branch(("GenLepton_" + floatNames[i]).c_str(), &leptonVariables[i]);
+            }
 
-       for(unsigned int i=0; i<floatNames.size(); i++){
-            tree->Branch(("GenPartFromh2_" + floatNames[i]).c_str(), &h2Variables[i]);
+            for(unsigned int i=0; i<floatNames.size(); i++){
+                tree->Branch(("GenPartFromh1_" + floatNames[i]).c_str(), &h1Variables[i]);
+            }
+
+           for(unsigned int i=0; i<floatNames.size(); i++){
+                tree->Branch(("GenPartFromh2_" + floatNames[i]).c_str(), &h2Variables[i]);
+            }
         }
     }
 }
 
 
-void GenPartAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
+void GenPartAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     //Clear vectors
     for(std::vector<float>& variable: leptonVariables){
         variable = std::vector<float>(2, -999.);
@@ -56,94 +66,49 @@ void GenPartAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event*
 
     if(!isData){
         if(!isNANO){
-            event->getByToken(genParticleToken, genParts);
+            genParts = context->GenParticles();
         }
 
-        int size = isNANO ? genID->GetSize() : genParts->size();
+        const GenealogyTable& genealogy = isNANO ? Genealogy() : Genealogy(*genParts);
 
-        //Fill 4 four vectors
-        for(int i = 0; i < size; i++){
-            int ID = isNANO ? abs(genID->At(i)) : abs(genParts->at(i).pdgId());  
+        //Fill 4 four vectors, each chain of copies of a particle only once
+        for(unsigned int i = 0; i < genealogy.Size(); i++){
+            int ID = genealogy.PdgID(i);
 
-            if(ID == 11 or ID == 12 or ID == 13 or ID == 14){
-                const reco::Candidate* part=NULL;
-                int index=0;
+            if(genealogy.FirstCopy(i) != (int)i) continue;
+            if(ID != 11 and ID != 12 and ID != 13 and ID != 14 and ID != 5) continue;
 
-                if(isNANO) index = LastCopy(i, ID);
-                else part = LastCopy(genParts->at(i), ID);
+            float pt, eta, phi, m;
+            pt = isNANO ? genPt->At(i) : genParts->at(i).pt();
+            phi = isNANO ? genPhi->At(i) : genParts->at(i).phi();
+            eta = isNANO ? genEta->At(i) : genParts->at(i).eta();
+            m = isNANO ? genMass->At(i) : genParts->at(i).mass();
 
-                int motherID = isNANO ? abs(genID->At(index)) : abs(part->mother()->pdgId()); 
+            FourVector lVec = FourVector::PtEtaPhiM(pt, eta, phi, m);
 
-                float pt, eta, phi, m;
-                pt = isNANO ? genPt->At(index) : part->pt();
-                phi = isNANO ? genPhi->At(index) : part->phi();
-                eta = isNANO ? genEta->At(index) : part->eta();
-                m = isNANO ? genMass->At(index) : part->mass();
-
-                TLorentzVector lVec;
-                lVec.SetPtEtaPhiM(pt, eta, phi, m);
-
-                if(motherID == 24){
-                    const reco::Candidate* part=NULL;
-                    int index=0;
-                
-                    if(isNANO) index = LastCopy(i, 24);
-                    else part = LastCopy(genParts->at(i), 24);
-
-                    int motherID = isNANO ? abs(genID->At(index)) : abs(part->mother()->pdgId()); 
+            if(ID != 5 and genealogy.GetOrigin(i) == GenealogyTable::HC_W){
+                //Lepton four momentum components
+                leptonVariables[0][ID%2==0 ? 0 : 1] = lVec.E();   //Energy
+                leptonVariables[1][ID%2==0 ? 0 : 1] = lVec.Px();  //Px
+                leptonVariables[2][ID%2==0 ? 0 : 1] = lVec.Py();  //Py
+                leptonVariables[3][ID%2==0 ? 0 : 1] = lVec.Pz();  //Pz
+            }
 
-                    if(motherID == 37){
-                        //Lepton four momentum components
-                        leptonVariables[0][ID%2==0 ? 0 : 1] = lVec.E();   //Energy
-                        leptonVariables[1][ID%2==0 ? 0 : 1] = lVec.Px();  //Px
-                        leptonVariables[2][ID%2==0 ? 0 : 1] = lVec.Py();  //Py
-                        leptonVariables[3][ID%2==0 ? 0 : 1] = lVec.Pz();  //Pz
-                    }
+            if(ID == 5 and genealogy.AncestorID(i) == 25){
+                if(genealogy.GetOrigin(i) == GenealogyTable::HC_H and h1Variables[0].size() < 2){
+                    //Quark four momentum components
+                    h1Variables[0].push_back(lVec.E());   //Energy
+                    h1Variables[1].push_back(lVec.Px());  //Px
+                    h1Variables[2].push_back(lVec.Py());  //Py
+                    h1Variables[3].push_back(lVec.Pz());  //Pz
                 }
-            } 
-
-            if(ID == 5){
-                const reco::Candidate* part=NULL;
-                int index=0;
-
-                if(isNANO) index = LastCopy(i, ID);
-                else part = LastCopy(genParts->at(i), ID);
-
-                int motherID = isNANO ? abs(genID->At(index)) : abs(part->mother()->pdgId()); 
-
-                float pt, eta, phi, m;
-                pt = isNANO ? genPt->At(index) : part->pt();
-                phi = isNANO ? genPhi->At(index) : part->phi();
-                eta = isNANO ? genEta->At(index) : part->eta();
-                m = isNANO ? genMass->At(index) : part->mass();
-
-                TLorentzVector lVec;
-                lVec.SetPtEtaPhiM(pt, eta, phi, m);
-
-                if(motherID == 25){
-                    const reco::Candidate* part=NULL;
-                    int index=0;
-                
-                    if(isNANO) index = LastCopy(i, 25);
-                    else part = LastCopy(genParts->at(i), 25);
-
-                    int motherID = isNANO ? abs(genID->At(index)) : abs(part->mother()->pdgId()); 
-
-                    if(motherID == 37 and h1Variables[0].size() < 2){
-                        //Quark four momentum components
-                        h1Variables[0].push_back(lVec.E());   //Energy
-                        h1Variables[1].push_back(lVec.Px());  //Px
-                        h1Variables[2].push_back(lVec.Py());  //Py
-                        h1Variables[3].push_back(lVec.Pz());  //Pz
-                    }
             
-                    else if(h2Variables[0].size() < 2){
-                        //Quark four momentum components
-                        h2Variables[0].push_back(lVec.E());   //Energy
-                        h2Variables[1].push_back(lVec.Px());  //Px
-                        h2Variables[2].push_back(lVec.Py());  //Py
-                        h2Variables[3].push_back(lVec.Pz());  //Pz
-                    }
+                else if(h2Variables[0].size() < 2){
+                    //Quark four momentum components
+                    h2Variables[0].push_back(lVec.E());   //Energy
+                    h2Variables[1].push_back(lVec.Px());  //Px
+                    h2Variables[2].push_back(lVec.Py());  //Py
+                    h2Variables[3].push_back(lVec.Pz());  //Pz
                 }
             }
         }
@@ -156,6 +121,12 @@ void GenPartAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event*
             std::sort(h2Variables.begin(), h2Variables.end(), sortFunc);
         }
     }
+
+    if(flatOutput){
+        leptonCollection.Fill(leptonVariables);
+        h1Collection.Fill(h1Variables);
+        h2Collection.Fill(h2Variables);
+    }
 }
 
 
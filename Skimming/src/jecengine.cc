@@ -0,0 +1,177 @@
+#include <ChargedSkimming/Skimming/interface/jecengine.h>
+#include <ChargedSkimming/Skimming/interface/calibrationcache.h>
+
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <cstring>
+
+JECEngine::JECEngine(){}
+
+JECEngine::JECEngine(const std::vector<std::string> &fileNames):
+    fileNames(fileNames){
+
+    std::map<std::string, int> variables = {{"JetEta", ETA}, {"JetPt", PT}, {"Rho", RHO}, {"JetA", AREA}};
+
+    for(const std::string &fileName: fileNames){
+        levels.push_back(JMETable(fileName));
+
+        std::vector<int> binIndex, parIndex;
+
+        for(const std::string &name: levels.back().BinVariables()){
+            binIndex.push_back(variables.count(name) ? variables[name] : -1);
+        }
+
+        for(const std::string &name: levels.back().ParVariables()){
+            parIndex.push_back(variables.count(name) ? variables[name] : -1);
+        }
+
+        //Tables only know eta, pt, rho and area of the jet
+        if(std::find(binIndex.begin(), binIndex.end(), -1) != binIndex.end() or std::find(parIndex.begin(), parIndex.end(), -1) != parIndex.end()){
+            std::cout << "JEC file uses jet variables not supported by JECEngine, use FactorizedJetCorrector: " << fileName << std::endl;
+            SetFallback();
+        }
+
+        binIndices.push_back(binIndex);
+        parIndices.push_back(parIndex);
+    }
+}
+
+void JECEngine::SetFallback(){
+    std::vector<JetCorrectorParameters> corrVec;
+
+    for(const std::string &fileName: fileNames){
+        corrVec.push_back(JetCorrectorParameters(fileName));
+    }
+
+    fallback = std::make_shared<FactorizedJetCorrector>(corrVec);
+}
+
+float JECEngine::GetCorrection(const float &pt, const float &eta, const float &rho, const float &area) const {
+    if(fallback){
+        fallback->setJetPt(pt);
+        fallback->setJetEta(eta);
+        fallback->setRho(rho);
+        fallback->setJetA(area);
+
+        return fallback->getCorrection();
+    }
+
+    double values[4] = {eta, pt, rho, area};
+    double binValues[4], parValues[4];
+    double correction = 1.;
+
+    for(unsigned int level = 0; level < levels.size(); level++){
+        for(unsigned int i = 0; i < binIndices[level].size(); i++) binValues[i] = values[binIndices[level][i]];
+        for(unsigned int i = 0; i < parIndices[level].size(); i++) parValues[i] = values[parIndices[level][i]];
+
+        //No correction outside of the bins, as in FactorizedJetCorrector
+        int record = levels[level].FindBin(binValues);
+        if(record < 0) continue;
+
+        //Next level is evaluated with corrected pt
+        double factor = levels[level].Evaluate(record, parValues);
+        values[PT] *= factor;
+        correction *= factor;
+    }
+
+    return correction;
+}
+
+void JECEngine::GetCorrections(const std::vector<float> &pt, const std::vector<float> &eta, const float &rho, const std::vector<float> &area, std::vector<float> &corrections) const {
+    corrections.assign(pt.size(), 1.);
+
+    if(fallback){
+        for(unsigned int j = 0; j < pt.size(); j++){
+            corrections[j] = GetCorrection(pt[j], eta[j], rho, area[j]);
+        }
+
+        return;
+    }
+
+    std::vector<double> correctedPt(pt.begin(), pt.end());
+    double values[4], binValues[4], parValues[4];
+
+    for(unsigned int level = 0; level < levels.size(); level++){
+        for(unsigned int j = 0; j < pt.size(); j++){
+            values[ETA] = eta[j]; values[PT] = correctedPt[j]; values[RHO] = rho; values[AREA] = area[j];
+
+            for(unsigned int i = 0; i < binIndices[level].size(); i++) binValues[i] = values[binIndices[level][i]];
+            for(unsigned int i = 0; i < parIndices[level].size(); i++) parValues[i] = values[parIndices[level][i]];
+
+            int record = levels[level].FindBin(binValues);
+            if(record < 0) continue;
+
+            double factor = levels[level].Evaluate(record, parValues);
+            correctedPt[j] *= factor;
+            corrections[j] *= factor;
+        }
+    }
+}
+
+float JECEngine::Compare() const {
+    std::vector<JetCorrectorParameters> corrVec;
+
+    for(const std::string &fileName: fileNames){
+        corrVec.push_back(JetCorrectorParameters(fileName));
+    }
+
+    FactorizedJetCorrector corrector(corrVec);
+    float maxDeviation = 0.;
+
+    //Grid covering the full detector, pt range of the files and AK4/AK8 areas
+    for(float eta = -4.95; eta < 5.; eta += 0.3){
+        for(float pt = 10.; pt < 5000.; pt *= 1.6){
+            for(float rho: {0., 5., 15., 30., 60.}){
+                for(float area: {0.3, 0.5, 0.8, 2.}){
+                    corrector.setJetPt(pt);
+                    corrector.setJetEta(eta);
+                    corrector.setRho(rho);
+                    corrector.setJetA(area);
+
+                    float reference = corrector.getCorrection();
+                    float deviation = std::abs(GetCorrection(pt, eta, rho, area) - reference)/std::max(std::abs(reference), 1e-4f);
+
+                    maxDeviation = std::max(maxDeviation, deviation);
+                }
+            }
+        }
+    }
+
+    return maxDeviation;
+}
+
+float JECEngine::Validate(const float &tolerance){
+    if(fallback) return 0.;
+
+    //Result of the comparison is cached for the combination of tables, so jobs do not need to parse the text files
+    std::string tableFiles;
+
+    for(const JMETable &level: levels){
+        tableFiles += level.CacheFile();
+    }
+
+    std::string validationFile = CalibrationCache::Path("jecvalidation", CalibrationCache::Checksum(tableFiles));
+    CalibrationCache cache(validationFile);
+
+    float maxDeviation = 0.;
+
+    if(cache.IsOpen() and cache.Size() == sizeof(maxDeviation)){
+        std::memcpy(&maxDeviation, cache.Data(), sizeof(maxDeviation));
+    }
+
+    else{
+        maxDeviation = Compare();
+
+        const char* deviation = reinterpret_cast<const char*>(&maxDeviation);
+        CalibrationCache::Write(validationFile, std::vector<char>(deviation, deviation + sizeof(maxDeviation)));
+    }
+
+    if(maxDeviation > tolerance){
+        std::cout << "JECEngine deviates from FactorizedJetCorrector by " << maxDeviation << " (tolerance " << tolerance << "), use FactorizedJetCorrector" << std::endl;
+        SetFallback();
+    }
+
+    return maxDeviation;
+}
@@ -1,5 +1,7 @@
 #include <ChargedSkimming/Skimming/interface/jetanalyzer.h>
 
+#include <algorithm>
+
 JetAnalyzer::JetAnalyzer(const int &era, const float &ptCut, const float &etaCut, TTreeReader &reader):
     BaseAnalyzer(&reader),    
     era(era),
@@ -7,104 +9,109 @@ JetAnalyzer::JetAnalyzer(const int &era, const float &ptCut, const float &etaCut
     etaCut(etaCut)
     {}
 
-JetAnalyzer::JetAnalyzer(const int &era, const float &ptCut, const float &etaCut, std::vector<jToken>& jetTokens, std::vector<genjToken>& genjetTokens, mToken &metToken, edm::EDGetTokenT<double> &rhoToken, genPartToken& genParticleToken, secvtxToken& vertexToken):
+JetAnalyzer::JetAnalyzer(const int &era, const float &ptCut, const float &etaCut):
     BaseAnalyzer(),    
     era(era),
     ptCut(ptCut),
-    etaCut(etaCut),
-    jetTokens(jetTokens),
-    metToken(metToken),
-    rhoToken(rhoToken),
-    genParticleToken(genParticleToken),
-    vertexToken(vertexToken)
+    etaCut(etaCut)
     {}
 
 
-void JetAnalyzer::SetCorrector(const JetType &type, const int& runNumber){
-    std::vector<JetCorrectorParameters> corrVec;
+std::string JetAnalyzer::GetEra(const int &runNumber){
+    if(eraNames.empty()) return "";
 
-    for(std::string fileName: isData? JECDATA[type][era] : JECMC[type][era]){
-        if(fileName.find("@") != std::string::npos){
-            for(std::pair<std::string, std::pair<int, int>> eraNames: runEras[era]){
-                if(eraNames.second.first <= runNumber and runNumber <= eraNames.second.second){
-                    fileName.replace(fileName.find("@"), 1, eraNames.first);
-                }
+    //Last era starting before the run, runs before the first era are corrected with the first era
+    std::vector<int>::iterator eraIt = std::upper_bound(eraFirstRun.begin(), eraFirstRun.end(), runNumber);
+
+    return eraNames[eraIt == eraFirstRun.begin() ? 0 : eraIt - eraFirstRun.begin() - 1];
+}
+
+void JetAnalyzer::SetCorrector(const JetType &type, const std::string &eraName){
+    std::pair<JetType, std::string> key = {type, eraName};
+
+    //Files of each era are only parsed once
+    if(!correctorCache.count(key)){
+        std::vector<std::string> fileNames;
+
+        for(std::string fileName: isData? JECDATA[type][era] : JECMC[type][era]){
+            if(fileName.find("@") != std::string::npos){
+                fileName.replace(fileName.find("@"), 1, eraName);
             }
+
+            fileNames.push_back(fileName);
         }
 
-        corrVec.push_back(JetCorrectorParameters(fileName));
+        //Tables are checked once against FactorizedJetCorrector, which is used instead if they deviate
+        //https://twiki.cern.ch/twiki/bin/view/CMSPublic/WorkBookJetEnergyCorrections#JetEnCorFWLite
+        correctorCache[key] = std::make_shared<JECEngine>(fileNames);
+        correctorCache[key]->Validate(1e-5);
     }
 
-    jetCorrector[type] = new FactorizedJetCorrector(corrVec);
+    jetCorrector[type] = correctorCache[key];
 }
 
-//https://twiki.cern.ch/twiki/bin/view/CMSPublic/WorkBookJetEnergyCorrections#JetEnCorFWLite
-float JetAnalyzer::CorrectEnergy(const TLorentzVector &jet, const float &rho, const float &area, const JetType &type){
-    jetCorrector[type]->setJetPt(jet.Pt());
-    jetCorrector[type]->setJetEta(jet.Eta());
-    jetCorrector[type]->setRho(rho);
-    jetCorrector[type]->setJetA(area);
+void JetAnalyzer::MatchGenJets(const JetType &type, const float &rho, const std::vector<reco::GenJet> &genJets){
+    unsigned int size = isNANO ? (type == AK4 ? genJetPt->GetSize() : genFatJetPt->GetSize()) : genJets.size();
+    std::vector<float> genEtas, genPhis;
 
-    double correction = jetCorrector[type]->getCorrection();
-    
-    return correction;
+    genJetVectors[type].clear();
+
+    for(unsigned int i = 0; i < size; i++){
+        FourVector gJet;
+
+        if(isNANO){
+            if(type == AK4) gJet = FourVector::PtEtaPhiM(genJetPt->At(i), genJetEta->At(i), genJetPhi->At(i), genJetMass->At(i));
+            else gJet = FourVector::PtEtaPhiM(genFatJetPt->At(i), genFatJetEta->At(i), genFatJetPhi->At(i), genFatJetMass->At(i));
+        }
+
+        else gJet = FourVector::PtEtaPhiM(genJets.at(i).pt(), genJets.at(i).eta(), genJets.at(i).phi(), genJets.at(i).mass());
+
+        genJetVectors[type].push_back(gJet);
+        genEtas.push_back(gJet.Eta());
+        genPhis.push_back(gJet.Phi());
+    }
+
+    genJetIndex[type].Build(genEtas, genPhis);
+
+    //Corrected pt and allowed pt difference of reco jets, which is three times the resolution
+    std::vector<float> correctedPt, maxDeltaPt;
+
+    for(unsigned int i = 0; i < rawPt.size(); i++){
+        correctedPt.push_back(rawPt[i]*corrFactors[type][i]);
+
+        jetParameter.setJetPt(correctedPt[i]).setJetEta(rawEta[i]).setRho(rho);
+        maxDeltaPt.push_back(3.*resolution[type].getResolution(jetParameter)*correctedPt[i]);
+    }
+
+    //Best match within half the cone size, each gen jet is matched to one reco jet only
+    float coneSize = type == AK4 ? 0.4 : 0.8;
+
+    genJetIndex[type].Match(rawEta, rawPhi, coneSize/2., genMatch[type], [&](const unsigned int &i, const unsigned int &j){
+        return std::abs(correctedPt[i] - genJetVectors[type][j].Pt()) < maxDeltaPt[i];
+    });
 }
 
 //https://twiki.cern.ch/twiki/bin/viewauth/CMS/JetResolution#Smearing_procedures
 //https://github.com/cms-sw/cmssw/blob/CMSSW_8_0_25/PhysicsTools/PatUtils/interface/SmearedJetProducerT.h#L203-L263
-float JetAnalyzer::SmearEnergy(const TLorentzVector &jet, const float &rho, const float &coneSize, const JetType &type, const std::vector<reco::GenJet> &genJets){
+float JetAnalyzer::SmearEnergy(const FourVector &jet, const float &rho, const JetType &type, const float &gausDraw, const int &genIdx, const JME::Variation &variation){
     //Configure jet SF reader
     jetParameter.setJetPt(jet.Pt()).setJetEta(jet.Eta()).setRho(rho);
 
-    float dR;
     float reso = resolution[type].getResolution(jetParameter);
-    float resoSF = resolution_sf[type].getScaleFactor(jetParameter);
+    float resoSF = resolution_sf[type].getScaleFactor(jetParameter, variation);
     float smearFac = 1.; 
 
-    float genPt, genPhi, genEta, genMass;
-    unsigned int size;
-
-    if(isNANO) size = (type == AK4) ? genJetPt->GetSize(): genFatJetPt->GetSize();
-    else size = genJets.size();
-
-    //Loop over all gen jets and find match
-    for(unsigned int i = 0; i < size; i++){
-        if(isNANO){
-            genPt = (type == AK4) ? genJetPt->At(i): genFatJetPt->At(i);
-            genPhi = (type == AK4) ? genJetPhi->At(i): genFatJetPhi->At(i);
-            genEta = (type == AK4) ? genJetEta->At(i): genFatJetEta->At(i);
-            genMass = (type == AK4) ? genJetMass->At(i): genFatJetMass->At(i);
-        }
-
-        else{
-            genPt = genJets.at(i).pt();
-            genPhi = genJets.at(i).phi();
-            genEta = genJets.at(i).eta();
-            genMass = genJets.at(i).mass();
-        }
-
-        dR = std::sqrt(std::pow(jet.Phi()-genPhi, 2) + std::pow(jet.Eta()-genEta, 2));
-
-        //Check if jet and gen jet are matched
-        if(dR < coneSize/2. and abs(jet.Pt() - genPt) < 3.*reso*jet.Pt()){
-            TLorentzVector gJet;
-            gJet.SetPtEtaPhiM(genPt, genEta, genPhi, genMass);
-            genJet[type] = gJet;
-            break;
-        }
-    }  
+    //Gen jet matched in MatchGenJets
+    genJet[type] = genIdx >= 0 ? genJetVectors[type][genIdx] : FourVector();
 
     //If you found gen matched 
-    if(genJet[type] != TLorentzVector()){
+    if(!genJet[type].IsZero()){
         smearFac = 1.+(resoSF-1)*(jet.Pt() - genJet[type].Pt())/jet.Pt(); 
     }
 
     //If no match, smear with gaussian pdf
     else if(resoSF > 1.){
-        std::default_random_engine generator;
-        std::normal_distribution<> gaus(0, reso * std::sqrt(resoSF * resoSF - 1));
-
-        smearFac = 1. + gaus(generator);
+        smearFac = 1. + gausDraw * reso * std::sqrt(resoSF * resoSF - 1);
     }
 
 
@@ -116,61 +123,67 @@ float JetAnalyzer::SmearEnergy(const TLorentzVector &jet, const float &rho, cons
     return smearFac;
 }
 
-int JetAnalyzer::SetGenParticles(TLorentzVector& validJet, const int &i, const int &pdgID, const JetType &type, const std::vector<reco::GenParticle>& genParticle){
-    int nParton=0;
-    bool isFromh1 = true;
-    bool isFromh2 = true;
+void JetAnalyzer::SetVariationFactors(const JetType &type, const FourVector &jet, const float &rho, const unsigned int &i, const float &smearFac){
+    variationFactors.assign(nVariations, 1.);
+    if(nVariations == 1) return;
 
-    //Check if gen matched particle exist
-    if(genJet[type].Pt() != 0){
-        float dR;
-        
-        //Find Gen particle to gen Jet
-        int size=isNANO ? genPt->GetSize() : genParticle.size();
+    //JES uncertainty at corrected pt, https://twiki.cern.ch/twiki/bin/view/CMS/JECUncertaintySources
+    double eta = jet.Eta();
+    int record = jesUncertainty[type].FindBin(&eta);
 
-        for(int i=0; i < size; i++){
-            const reco::Candidate* parton=NULL;
-            int index=0;
+    if(record >= 0){
+        variationFactors[JESUP] = 1. + jesUncertainty[type].Uncertainty(record, jet.Pt(), true);
+        variationFactors[JESDOWN] = 1. - jesUncertainty[type].Uncertainty(record, jet.Pt(), false);
+    }
 
-            int ID = isNANO ? abs(genID->At(genMotherIdx->At(i))) : abs(genParticle.at(i).pdgId());
-    
-            if(ID == pdgID){
-                if(isNANO) index = LastCopy(i, pdgID);
-                else parton = LastCopy(genParticle.at(i), pdgID);
-            }
-    
-            else continue;
+    //JER smearing with varied resolution scale factor, same gen jet and random number as nominal
+    variationFactors[JERUP] = SmearEnergy(jet, rho, type, gausDraws[type][i], genMatch[type][i], JME::UP)/smearFac;
+    variationFactors[JERDOWN] = SmearEnergy(jet, rho, type, gausDraws[type][i], genMatch[type][i], JME::DOWN)/smearFac;
+}
+
+void JetAnalyzer::SetPartons(const int &pdgID, const std::vector<reco::GenParticle>& genParticle){
+    const GenealogyTable& genealogy = Genealogy(genParticle);
+    std::vector<float> etas, phis;
 
-            float eta, phi;
-            phi = isNANO ? genPhi->At(index) : parton->phi();
-            eta = isNANO ? genEta->At(index) : parton->eta();
+    partonIndices.clear();
 
-            dR = std::sqrt(std::pow(phi - genJet[type].Phi(), 2) + std::pow(eta-genJet[type].Eta(), 2));
-            float rMin = type == AK4 ? 0.3 : 0.4;
+    //First copy of each parton
+    for(unsigned int i = 0; i < genealogy.Size(); i++){
+        if(genealogy.PdgID(i) != pdgID or genealogy.FirstCopy(i) != (int)i) continue;
 
-            if(dR <  rMin){
-                int motherID = isNANO ? abs(genID->At(genMotherIdx->At(index))) : abs(parton->mother()->pdgId());
+        partonIndices.push_back(i);
+        etas.push_back(isNANO ? genEta->At(i) : genParticle.at(i).eta());
+        phis.push_back(isNANO ? genPhi->At(i) : genParticle.at(i).phi());
+    }
 
-                if(motherID == 25){
-                    const reco::Candidate* hBoson=NULL;
-                    int index=0;
+    partonIndex.Build(etas, phis);
+}
 
-                    nParton++;
-                                
-                    if(isNANO) index = LastCopy(index, 25);
-                    else hBoson = LastCopy(parton->mother(), 25);
+int JetAnalyzer::SetGenParticles(FourVector& validJet, const int &i, const JetType &type){
+    int nParton=0;
+    bool isFromh1 = true;
+    bool isFromh2 = true;
 
-                    int motherID = isNANO ? abs(genID->At(genMotherIdx->At(index))) : abs(hBoson->mother()->pdgId());  
+    //Check if gen matched particle exist
+    if(genJet[type].Pt() != 0){
+        //Partons close to the gen jet, in order of the gen particle collection
+        float rMin = type == AK4 ? 0.3 : 0.4;
+        partonIndex.Candidates(genJet[type].Eta(), genJet[type].Phi(), rMin, partonCands);
 
-                    if(motherID == 37){
-                        isFromh1 = isFromh1 && true;
-                        isFromh2 = isFromh2 && true;
-                    }
+        for(const unsigned int &j: partonCands){
+            int index = partonIndices[j];
 
-                    else{
-                        isFromh1 = isFromh1 && false;
-                        isFromh2 = isFromh2 && true;
-                    }
+            if(genealogy->AncestorID(index) == 25){
+                nParton++;
+
+                if(genealogy->GetOrigin(index) == GenealogyTable::HC_H){
+                    isFromh1 = isFromh1 && true;
+                    isFromh2 = isFromh2 && true;
+                }
+
+                else{
+                    isFromh1 = isFromh1 && false;
+                    isFromh2 = isFromh2 && true;
                 }
             }
 
@@ -188,7 +201,7 @@ int JetAnalyzer::SetGenParticles(TLorentzVector& validJet, const int &i, const i
 }
 
 
-void JetAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
+void JetAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
     JECMC = {
             {AK4, {
                 {2017, {filePath + "/JEC/Fall17_17Nov2017_V32_MC_L1FastJet_AK4PFchs.txt", 
@@ -259,6 +272,18 @@ void JetAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
             },
     };
 
+    JECUnc = {
+            {AK4, {
+                {2017, filePath + "/JEC/Fall17_17Nov2017_V32_MC_Uncertainty_AK4PFchs.txt"},
+                }
+            },       
+
+            {AK8, {
+                {2017, filePath + "/JEC/Fall17_17Nov2017_V32_MC_Uncertainty_AK8PFchs.txt"},
+                }
+            },
+    };
+
     //https://twiki.cern.ch/twiki/bin/viewauth/CMS/BtagRecommendation94
     bTagCuts = {
             {AK4, {
@@ -277,69 +302,105 @@ void JetAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
 
     if(isNANO){
         //Initiliaze TTreeReaderValues
-        fatJetPt = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_pt");
-        fatJetEta = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_eta");
-        fatJetPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_phi");
-        fatJetMass = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_mass");
-        fatJetArea = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_area");
-        fatJetCSV = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_btagDeepB");
-        fatJetTau1 = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_tau1");
-        fatJetTau2 = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_tau2");
-        fatJetTau3 = std::make_unique<TTreeReaderArray<float>>(*reader, "FatJet_tau3");
-
-        jetPt = std::make_unique<TTreeReaderArray<float>>(*reader, "Jet_pt");
-        jetEta = std::make_unique<TTreeReaderArray<float>>(*reader, "Jet_eta");
-        jetPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "Jet_phi");
-        jetMass = std::make_unique<TTreeReaderArray<float>>(*reader, "Jet_mass");
-        jetArea = std::make_unique<TTreeReaderArray<float>>(*reader, "Jet_area");
-        jetRho = std::make_unique<TTreeReaderValue<float>>(*reader, "fixedGridRhoFastjetAll");
-        jetDeepBValue = std::make_unique<TTreeReaderArray<float>>(*reader, "Jet_btagDeepFlavB");
-        valueHT = std::make_unique<TTreeReaderValue<float>>(*reader, "SoftActivityJetHT");
+        fatJetPt = input->Array<float>("FatJet_pt");
+        fatJetEta = input->Array<float>("FatJet_eta");
+        fatJetPhi = input->Array<float>("FatJet_phi");
+        fatJetMass = input->Array<float>("FatJet_mass");
+        fatJetArea = input->Array<float>("FatJet_area");
+        fatJetCSV = input->Array<float>("FatJet_btagDeepB");
+        fatJetTau1 = input->Array<float>("FatJet_tau1");
+        fatJetTau2 = input->Array<float>("FatJet_tau2");
+        fatJetTau3 = input->Array<float>("FatJet_tau3");
+
+        jetPt = input->Array<float>("Jet_pt");
+        jetEta = input->Array<float>("Jet_eta");
+        jetPhi = input->Array<float>("Jet_phi");
+        jetMass = input->Array<float>("Jet_mass");
+        jetArea = input->Array<float>("Jet_area");
+        jetRho = input->Value<float>("fixedGridRhoFastjetAll");
+        jetDeepBValue = input->Array<float>("Jet_btagDeepFlavB");
+        valueHT = input->Value<float>("SoftActivityJetHT");
         
-        metPhi = std::make_unique<TTreeReaderValue<float>>(*reader, "MET_phi");
-        metPt = std::make_unique<TTreeReaderValue<float>>(*reader, "MET_pt");
+        metPhi = input->Value<float>("MET_phi");
+        metPt = input->Value<float>("MET_pt");
 
         if(!this->isData){
-            genJetPt = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJet_pt");
-            genJetEta = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJet_eta");
-            genJetPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJet_phi");
-            genJetMass = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJet_mass");
-
-            genFatJetPt = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJetAK8_pt");
-            genFatJetEta = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJetAK8_eta");
-            genFatJetPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJetAK8_phi");
-            genFatJetMass = std::make_unique<TTreeReaderArray<float>>(*reader, "GenJetAK8_mass");
+            genJetPt = input->Array<float>("GenJet_pt");
+            genJetEta = input->Array<float>("GenJet_eta");
+            genJetPhi = input->Array<float>("GenJet_phi");
+            genJetMass = input->Array<float>("GenJet_mass");
+
+            genFatJetPt = input->Array<float>("GenJetAK8_pt");
+            genFatJetEta = input->Array<float>("GenJetAK8_eta");
+            genFatJetPhi = input->Array<float>("GenJetAK8_phi");
+            genFatJetMass = input->Array<float>("GenJetAK8_mass");
             
-            jetGenIdx = std::make_unique<TTreeReaderArray<int>>(*reader, "Jet_genJetIdx");
+            jetGenIdx = input->Array<int>("Jet_genJetIdx");
+
+            lumiBlock = input->Value<UInt_t>("luminosityBlock");
+            evtNumber = input->Value<ULong64_t>("event");
         }
 
         //Set TTreeReader for genpart and trigger obj from baseanalyzer
         SetCollection(this->isData);
     }
 
-    for(JetType type: {AK4, AK8}){
-        //Set configuration for bTagSF reader  ##https://twiki.cern.ch/twiki/bin/view/CMS/BTagCalibration
-        calib[type] = BTagCalibration(std::to_string(type), bTagSF[type][era]);
+    //Eras sorted by their first run
+    std::vector<std::pair<int, std::string>> eraRanges;
 
-        looseReader[type] = BTagCalibrationReader(BTagEntry::OP_LOOSE, "central", {"up", "down"});
-        mediumReader[type] = BTagCalibrationReader(BTagEntry::OP_MEDIUM, "central", {"up", "down"});  
-        tightReader[type] = BTagCalibrationReader(BTagEntry::OP_TIGHT, "central", {"up", "down"});  
+    for(const std::pair<const std::string, std::pair<int, int>>& eraRange: runEras[era]){
+        eraRanges.push_back({eraRange.second.first, eraRange.first});
+    }
 
-        looseReader[type].load(calib[type],  BTagEntry::FLAV_B, (type==AK4) ? "comb": "lt");  
-        mediumReader[type].load(calib[type],  BTagEntry::FLAV_B, (type==AK4) ? "comb": "lt");  
-        
-        if(type!=AK8){
-            tightReader[type].load(calib[type],  BTagEntry::FLAV_B, (type==AK4) ? "comb": "lt");  
-        }
+    std::sort(eraRanges.begin(), eraRanges.end());
+
+    for(const std::pair<int, std::string>& eraRange: eraRanges){
+        eraFirstRun.push_back(eraRange.first);
+        eraNames.push_back(eraRange.second);
+    }
+
+    //Systematic variations only for MC
+    nVariations = systematics and !isData ? variationNames.size() : 1;
+
+    for(JetType type: {AK4, AK8}){
+        //Set configuration for bTagSF table  ##https://twiki.cern.ch/twiki/bin/view/CMS/BTagCalibration
+        if(type == AK4) bTagTable[type] = BTagSFTable(bTagSF[type][era], "comb", {BTagEntry::OP_LOOSE, BTagEntry::OP_MEDIUM, BTagEntry::OP_TIGHT});
+        else bTagTable[type] = BTagSFTable(bTagSF[type][era], "lt", {BTagEntry::OP_LOOSE, BTagEntry::OP_MEDIUM});
     
         //Set configuration for JER tools
         resolution[type] = JME::JetResolution(JMEPtReso[type][era]);
         resolution_sf[type] = JME::JetResolutionScaleFactor(JMESF[type][era]);
+
+        //Set configuration for JES uncertainty
+        if(nVariations > 1) jesUncertainty[type] = JMETable(JECUnc[type][era]);
     }
 
     //Set output names
-    JetfloatNames = {"E", "Px", "Py", "Pz", "loosebTagSF", "mediumbTagSF", "tightbTagSF", "FatJetIdx", "isFromh"};
-    FatJetfloatNames = {"E", "Px", "Py", "Pz", "oneSubJettiness", "twoSubJettiness", "threeSubJettiness", "loosebTagSF", "mediumbTagSF", "isFromh"};
+    JetfloatNames = {"E", "Px", "Py", "Pz", "loosebTagSF", "mediumbTagSF", "tightbTagSF", "FatJetIdx", "isFromh", "loosebTagSFUp", "loosebTagSFDown", "mediumbTagSFUp", "mediumbTagSFDown", "tightbTagSFUp", "tightbTagSFDown"};
+    FatJetfloatNames = {"E", "Px", "Py", "Pz", "oneSubJettiness", "twoSubJettiness", "threeSubJettiness", "loosebTagSF", "mediumbTagSF", "isFromh", "loosebTagSFUp", "loosebTagSFDown", "mediumbTagSFUp", "mediumbTagSFDown"};
+
+    //Output column of each btag SF (central, up, down per working point)
+    bTagColumns = {
+        {AK4, {4, 9, 10, 5, 11, 12, 6, 13, 14}},
+        {AK8, {7, 10, 11, 8, 12, 13}},
+    };
+
+    //Factor of each variation relative to nominal four momentum and bit mask of variations in which the jet is selected (bit 0 nominal)
+    if(nVariations > 1){
+        for(std::vector<std::string>* names: {&JetfloatNames, &FatJetfloatNames}){
+            variationColumn[names == &JetfloatNames ? AK4 : AK8] = names->size();
+
+            for(unsigned int v = 1; v < nVariations; v++){
+                names->push_back(variationNames[v] + "Factor");
+            }
+
+            names->push_back("variationMask");
+        }
+    }
+
+    metPxVariation = std::vector<float>(nVariations, 0.);
+    metPyVariation = std::vector<float>(nVariations, 0.);
+    HTVariation = std::vector<float>(nVariations, 0.);
     JetParticlefloatNames = {"E", "Px", "Py", "Pz", "Vx", "Vy", "Vz", "Charge", "FatJetIdx"};
 
     boolNames = {"isLooseB", "isMediumB", "isTightB"};
@@ -353,38 +414,61 @@ void JetAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     FatJetboolVariables = std::vector<std::vector<bool>>(boolNames.size()-1, std::vector<bool>());
 
     //Set Branches of output tree
-    for(TTree* tree: trees){
-        for(unsigned int i=0; i<JetfloatVariables.size(); i++){
-            tree->Branch(("Jet_" + JetfloatNames[i]).c_str(), &JetfloatVariables[i]);
+    if(flatOutput){
+        jetCollection = FlatCollection("Jet", JetfloatNames, boolNames, {"FatJetIdx", "variationMask"});
+        fatJetCollection = FlatCollection("FatJet", FatJetfloatNames, std::vector<std::string>(boolNames.begin(), boolNames.end()-1), {"variationMask"});
+        jetParticleCollection = FlatCollection("JetParticle", JetParticlefloatNames, {}, {"FatJetIdx"});
+        vertexCollection = FlatCollection("SecondaryVertex", JetParticlefloatNames, {}, {"FatJetIdx"});
+
+        for(FlatCollection* collection: {&jetCollection, &fatJetCollection, &jetParticleCollection, &vertexCollection}){
+            collection->Branch(trees);
         }
+    }
 
-        for(unsigned int i=0; i<FatJetfloatVariables.size(); i++){
-            tree->Branch(("FatJet_" + FatJetfloatNames[i]).c_str(), &FatJetfloatVariables[i]);
-        }
+    for(TTree* tree: trees){
+        if(!flatOutput){
+            for(unsigned int i=0; i<JetfloatVariables.size(); i++){
+                tree->Branch(("Jet_" + JetfloatNames[i]).c_str(), &JetfloatVariables[i]);
+            }
 
-        for(unsigned int i=0; i<JetParticlefloatVariables.size(); i++){
-            tree->Branch(("JetParticle_" + JetParticlefloatNames[i]).c_str(), &JetParticlefloatVariables[i]);
-        }
+            for(unsigned int i=0; i<FatJetfloatVariables.size(); i++){
+                tree->Branch(("FatJet_" + FatJetfloatNames[i]).c_str(), &FatJetfloatVariables[i]);
+            }
 
-        for(unsigned int i=0; i<VertexfloatVariables.size(); i++){
-            tree->Branch(("SecondaryVertex_" + JetParticlefloatNames[i]).c_str(), &VertexfloatVariables[i]);
-        }
+            for(unsigned int i=0; i<JetParticlefloatVariables.size(); i++){
+                tree->Branch(("JetParticle_" + JetParticlefloatNames[i]).c_str(), &JetParticlefloatVariables[i]);
+            }
+
+            for(unsigned int i=0; i<VertexfloatVariables.size(); i++){
+                tree->Branch(("SecondaryVertex_" + JetParticlefloatNames[i]).c_str(), &VertexfloatVariables[i]);
+            }
 
-        for(unsigned int i=0; i<boolNames.size(); i++){
-            tree->Branch(("Jet_" + boolNames[i]).c_str(), &JetboolVariables[i]);
-            if(i!=0){
-                tree->Branch(("FatJet_" + boolNames[i]).c_str(), &JetboolVariables[i-1]);
+            for(unsigned int i=0; i<boolNames.size(); i++){
+                tree->Branch(("Jet_" + boolNames[i]).c_str(), &JetboolVariables[i]);
+                if(i!=0){
+                    tree->Branch(("FatJet_" + boolNames[i]).c_str(), &JetboolVariables[i-1]);
+                }
             }
         }
 
         tree->Branch("MET_Px", &metPx);
         tree->Branch("MET_Py", &metPy);
         tree->Branch("HT", &HT);
+
+        for(unsigned int v = 1; v < nVariations; v++){
+            tree->Branch(("MET_Px_" + variationNames[v]).c_str(), &metPxVariation[v]);
+            tree->Branch(("MET_Py_" + variationNames[v]).c_str(), &metPyVariation[v]);
+            tree->Branch(("HT_" + variationNames[v]).c_str(), &HTVariation[v]);
+        }
+    }
+
+    for(CutFlow& cutflow: cutflows){
+        cutSteps.push_back(cutflow.AddStep("N^{AK4}_{jet} >= " + std::to_string(cutflow.nMinJet) + " && N^{AK8}_{jet} == " + std::to_string(cutflow.nMinFatjet)));
     }
 }
 
 
-void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
+void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     //Clear variables vector
     for(std::vector<float>& variable: JetfloatVariables){
         variable.clear();
@@ -410,14 +494,26 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
         variable.clear();
     }
 
-    int nSubJets=0;
     HT=0;
-    runNumber = isNANO ? *run->Get() : event->eventAuxiliary().id().run(); 
 
-    if(jetCorrector.empty()){
+    //Number of selected jets, jets overlapping with fat jets and fat jets for nominal and each variation
+    std::vector<unsigned int> nJetVariation(nVariations, 0), nSubVariation(nVariations, 0), nFatVariation(nVariations, 0);
+    std::vector<unsigned int> fatJetMasks;
+    std::vector<FourVector> fatJetVectors;
+
+    //Change of MET and HT by each variation
+    std::vector<float> metShiftX(nVariations, 0.), metShiftY(nVariations, 0.), HTShift(nVariations, 0.);
+    runNumber = isNANO ? *run->Get() : context->Run(); 
+
+    //Switch to corrector of the era of this run, MC has no eras
+    if(runNumber != correctorRun){
+        std::string eraName = isData ? GetEra(runNumber) : "";
+
         for(const JetType& type: {AK4, AK8}){
-            SetCorrector(type, runNumber);
+            SetCorrector(type, eraName);
         }
+
+        correctorRun = runNumber;
     }
 
     //Get Event info is using MINIAOD
@@ -431,15 +527,16 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
     edm::Handle<std::vector<reco::VertexCompositePtrCandidate>> secVtx;
 
     if(!isNANO){
-        event->getByToken(jetTokens[0], jets);
-        event->getByToken(jetTokens[1], fatJets);
-        event->getByToken(metToken, MET);
-        event->getByToken(rhoToken, rho);
-        event->getByToken(vertexToken, secVtx);
+        jets = context->Jets();
+        fatJets = context->FatJets();
+        MET = context->MET();
+        rho = context->Rho();
+        secVtx = context->SecVertices();
 
         if(!isData){
-            event->getByLabel(edm::InputTag("slimmedGenJets"), genJets);
-            event->getByLabel(edm::InputTag("slimmedGenJetsAK8"), genfatJets);
+            genJets = context->GenJets();
+            genfatJets = context->GenFatJets();
+            genParts = context->GenParticles();
         }
     }
 
@@ -450,6 +547,12 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
     //MET values not correct for JER yet
     metPx = isNANO ? *metPt->Get()*std::cos(*metPhi->Get()) : MET->at(0).uncorPx();
     metPy = isNANO ? *metPt->Get()*std::sin(*metPhi->Get()) : MET->at(0).uncorPy();
+
+    for(unsigned int v = 1; v < nVariations; v++){
+        metPxVariation[v] = metPx;
+        metPyVariation[v] = metPy;
+        HTVariation[v] = HT;
+    }
     
     float fatJetSize = isNANO ? fatJetPt->GetSize() : fatJets->size();
     float jetSize = isNANO ? jetPt->GetSize() : jets->size();
@@ -460,11 +563,60 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
     for(CutFlow& cutflow: cutflows){
         if(jetSize < cutflow.nMinJet){
             nMin++;
-            cutflow.passed = false;
+            cutflow.Reject();
         }
     }
 
     if(nMin == cutflows.size()) return;
+
+    //Raw jet kinematics for evaluating the JEC of all jets at once
+    float rhoValue = isNANO ? *jetRho->Get() : *rho;
+
+    for(const JetType& type: {AK4, AK8}){
+        unsigned int size = type == AK4 ? jetSize : fatJetSize;
+
+        rawPt.clear();
+        rawEta.clear();
+        rawPhi.clear();
+        rawArea.clear();
+
+        for(unsigned int i = 0; i < size; i++){
+            if(isNANO){
+                rawPt.push_back(type == AK4 ? jetPt->At(i) : fatJetPt->At(i));
+                rawEta.push_back(type == AK4 ? jetEta->At(i) : fatJetEta->At(i));
+                rawPhi.push_back(type == AK4 ? jetPhi->At(i) : fatJetPhi->At(i));
+                rawArea.push_back(type == AK4 ? jetArea->At(i) : fatJetArea->At(i));
+            }
+
+            else{
+                const pat::Jet& jet = type == AK4 ? jets->at(i) : fatJets->at(i);
+
+                rawPt.push_back(jet.pt());
+                rawEta.push_back(jet.eta());
+                rawPhi.push_back(jet.phi());
+                rawArea.push_back(jet.jetArea());
+            }
+        }
+
+        jetCorrector[type]->GetCorrections(rawPt, rawEta, rhoValue, rawArea, corrFactors[type]);
+
+        //Random numbers of all jets for JER smearing, jet type is used as stream to get independent numbers
+        if(!isData){
+            unsigned int lumi = isNANO ? *lumiBlock->Get() : context->LumiBlock();
+            unsigned long long eventNumber = isNANO ? *evtNumber->Get() : context->EventNumber();
+
+            Philox(runNumber, lumi, eventNumber, type).Gaus(size, gausDraws[type]);
+
+            if(isNANO) MatchGenJets(type, rhoValue);
+            else MatchGenJets(type, rhoValue, type == AK4 ? *genJets : *genfatJets);
+        }
+    }
+
+    //Partons for gen information of the jets
+    if(!isData){
+        if(isNANO) SetPartons(5);
+        else SetPartons(5, *genParts);
+    }
         
     //Loop over all fat jets
     for(unsigned int i = 0; i < fatJetSize; i++){
@@ -473,26 +625,50 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
         float fatPhi = isNANO ? fatJetPhi->At(i) : fatJets->at(i).phi();
         float fatMass = isNANO ? fatJetMass->At(i) : fatJets->at(i).mass();
 
-        TLorentzVector lVec;
-        lVec.SetPtEtaPhiM(fatPt, fatEta, fatPhi, fatMass);
+        FourVector lVec = FourVector::PtEtaPhiM(fatPt, fatEta, fatPhi, fatMass);
     
-        corrFac = isNANO ? CorrectEnergy(lVec,  *jetRho->Get(), fatJetArea->At(i), AK8) : CorrectEnergy(lVec, *rho, jets->at(i).jetArea(), AK8);
+        corrFac = corrFactors[AK8][i];
 
         //Smear pt if not data
         if(!isData){
-            smearFac = isNANO ? SmearEnergy(lVec*corrFac, *jetRho->Get(), 0.8, AK8) : SmearEnergy(lVec*corrFac, *rho, 0.8, AK8, *genfatJets);
+            smearFac = SmearEnergy(lVec*corrFac, rhoValue, AK8, gausDraws[AK8][i], genMatch[AK8][i]);
+            SetVariationFactors(AK8, lVec*corrFac, rhoValue, i, smearFac);
             lVec *= smearFac*corrFac;
         }
 
         else lVec *= corrFac;
 
-        if(lVec.Pt() > 170. and lVec.M() > 40. and abs(lVec.Eta()) < etaCut){
+        //Bit mask of nominal (bit 0) and variations in which the fat jet is selected
+        unsigned int mask = 0;
+
+        for(unsigned int v = 0; v < nVariations; v++){
+            float factor = v == 0 ? 1. : variationFactors[v];
+
+            if(lVec.Pt()*factor > 170. and lVec.M()*factor > 40. and abs(lVec.Eta()) < etaCut){
+                mask |= 1 << v;
+                nFatVariation[v]++;
+            }
+        }
+
+        if(mask != 0){
             //Fatjet four momentum components
             FatJetfloatVariables[0].push_back(lVec.E());   //Energy
             FatJetfloatVariables[1].push_back(lVec.Px());  //Px
             FatJetfloatVariables[2].push_back(lVec.Py());  //Py
             FatJetfloatVariables[3].push_back(lVec.Pz());  //Pz
 
+            //Variations of four momentum
+            if(nVariations > 1){
+                for(unsigned int v = 1; v < nVariations; v++){
+                    FatJetfloatVariables[variationColumn[AK8] + v - 1].push_back(variationFactors[v]);
+                }
+
+                FatJetfloatVariables[variationColumn[AK8] + nVariations - 1].push_back(mask);
+            }
+
+            fatJetMasks.push_back(mask);
+            fatJetVectors.push_back(lVec);
+
             //Check for btag
             float DeepCSV = 0;
 
@@ -516,15 +692,11 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
             FatJetfloatVariables[6].push_back(isNANO ? fatJetTau3->At(i) : fatJets->at(i).userFloat("ak8PFJetsCHSValueMap:NjettinessAK8CHSTau3"));
             if(!isData){
                 //btag SF
-                FatJetfloatVariables[7].push_back(looseReader[AK8].eval_auto_bounds("central", BTagEntry::FLAV_B, abs(lVec.Eta()), lVec.Pt()));
-                FatJetfloatVariables[8].push_back(mediumReader[AK8].eval_auto_bounds("central", BTagEntry::FLAV_B, abs(lVec.Eta()), lVec.Pt()));
+                bTagEta[AK8].push_back(abs(lVec.Eta()));
+                bTagPt[AK8].push_back(lVec.Pt());
 
 
-                if(isNANO) FatJetfloatVariables[9].push_back(SetGenParticles(lVec, i, 5, AK8));
-                else{
-                    event->getByToken(genParticleToken, genParts);
-                    FatJetfloatVariables[9].push_back(SetGenParticles(lVec, i, 5, AK8, *genParts));
-                }
+                FatJetfloatVariables[9].push_back(SetGenParticles(lVec, i, AK8));
             }
 
             //Fill in particle flow candidates
@@ -572,10 +744,7 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
                 }
 
                 for(const reco::VertexCompositePtrCandidate &vtx: *secVtx){
-                    TLorentzVector vtxP4;
-                    vtxP4.SetPtEtaPhiM(vtx.p4().Pt(), vtx.p4().Eta(), vtx.p4().Phi(), vtx.p4().M());
-
-                    if(lVec.DeltaR(vtxP4) < 0.8){
+                    if(lVec.DeltaR(vtx.eta(), vtx.phi()) < 0.8){
                         //SV four momentum components
                         VertexfloatVariables[0].push_back(vtx.energy());   //Energy
                         VertexfloatVariables[1].push_back(vtx.px());  //Px
@@ -604,14 +773,14 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
         float mass = isNANO ? jetMass->At(i) : jets->at(i).mass();
 
         //Define here already jet, because of smearing of 4-vec
-        TLorentzVector lVec;
-        lVec.SetPtEtaPhiM(pt, eta, phi, mass);
+        FourVector lVec = FourVector::PtEtaPhiM(pt, eta, phi, mass);
 
-        corrFac = isNANO ? CorrectEnergy(lVec,  *jetRho->Get(), jetArea->At(i), AK4) : CorrectEnergy(lVec, *rho, jets->at(i).jetArea(), AK4);
+        corrFac = corrFactors[AK4][i];
 
         //Smear pt if not data
         if(!isData){
-            smearFac = isNANO ? SmearEnergy(lVec*corrFac,  *jetRho->Get(), jetArea->At(i), AK4) : SmearEnergy(lVec, *rho, 0.4, AK4, *genJets);
+            smearFac = isNANO ? SmearEnergy(lVec*corrFac, rhoValue, AK4, gausDraws[AK4][i], genMatch[AK4][i]) : SmearEnergy(lVec, rhoValue, AK4, gausDraws[AK4][i], genMatch[AK4][i]);
+            SetVariationFactors(AK4, isNANO ? lVec*corrFac : lVec, rhoValue, i, smearFac);
 
             lVec*=smearFac*corrFac;
         }
@@ -627,13 +796,40 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
         //Calculate HT for miniAOD
         HT+=lVec.Pt();
 
-        if(lVec.Pt() > ptCut and abs(lVec.Eta()) < etaCut){
+        //Bit mask of nominal (bit 0) and variations in which the jet is selected
+        unsigned int mask = 0;
+
+        for(unsigned int v = 0; v < nVariations; v++){
+            float factor = v == 0 ? 1. : variationFactors[v];
+
+            if(v != 0){
+                metShiftX[v] += lVec.Px()*(factor - 1);
+                metShiftY[v] += lVec.Py()*(factor - 1);
+                HTShift[v] += lVec.Pt()*(factor - 1);
+            }
+
+            if(lVec.Pt()*factor > ptCut and abs(lVec.Eta()) < etaCut){
+                mask |= 1 << v;
+                nJetVariation[v]++;
+            }
+        }
+
+        if(mask != 0){
             //Fatjet four momentum components
             JetfloatVariables[0].push_back(lVec.E());   //Energy
             JetfloatVariables[1].push_back(lVec.Px());  //Px
             JetfloatVariables[2].push_back(lVec.Py());  //Py
             JetfloatVariables[3].push_back(lVec.Pz());  //Pz
 
+            //Variations of four momentum
+            if(nVariations > 1){
+                for(unsigned int v = 1; v < nVariations; v++){
+                    JetfloatVariables[variationColumn[AK4] + v - 1].push_back(variationFactors[v]);
+                }
+
+                JetfloatVariables[variationColumn[AK4] + nVariations - 1].push_back(mask);
+            }
+
             //Check for btag
             float DeepBValue = 0;
 
@@ -653,58 +849,91 @@ void JetAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
 
             if(!isData){
                 //btag SF
-                JetfloatVariables[4].push_back(looseReader[AK4].eval_auto_bounds("central", BTagEntry::FLAV_B, abs(lVec.Eta()), lVec.Pt()));
-                JetfloatVariables[5].push_back(mediumReader[AK4].eval_auto_bounds("central", BTagEntry::FLAV_B, abs(lVec.Eta()), lVec.Pt()));
-                JetfloatVariables[6].push_back(tightReader[AK4].eval_auto_bounds("central", BTagEntry::FLAV_B, abs(lVec.Eta()), lVec.Pt()));
+                bTagEta[AK4].push_back(abs(lVec.Eta()));
+                bTagPt[AK4].push_back(lVec.Pt());
 
-                if(isNANO) JetfloatVariables[8].push_back(SetGenParticles(lVec, i, 5, AK4));
-                else{
-                    event->getByToken(genParticleToken, genParts);
-                    JetfloatVariables[8].push_back(SetGenParticles(lVec, i, 5, AK4, *genParts));
-                }
+                JetfloatVariables[8].push_back(SetGenParticles(lVec, i, AK4));
             }
 
-            //Check overlap with AK4 valid jets
-            for(unsigned int j = 0; j < FatJetfloatVariables[0].size(); j++){
-                TLorentzVector FatlVec;
-                FatlVec.SetPxPyPzE(FatJetfloatVariables[1][j], FatJetfloatVariables[2][j], FatJetfloatVariables[3][j], FatJetfloatVariables[0][j]);
+            //Check overlap with AK4 valid jets, index of first overlapping fat jet or -1
+            float fatJetIdx = -1.;
+            unsigned int subJetMask = 0;
 
-                if(FatlVec.DeltaR(lVec) < 1.2){
-                    JetfloatVariables[7].push_back(j);
-                    nSubJets++;
-                }
+            for(unsigned int j = 0; j < fatJetVectors.size(); j++){
+                if(fatJetVectors[j].DeltaR(lVec) < 1.2){
+                    if(fatJetIdx < 0) fatJetIdx = j;
 
-                else{
-                    JetfloatVariables[7].push_back(-1.);
+                    //Variations in which both jets are selected
+                    subJetMask |= mask & fatJetMasks[j];
                 }
             }
+
+            for(unsigned int v = 0; v < nVariations; v++){
+                if(subJetMask & (1 << v)) nSubVariation[v]++;
+            }
+
+            JetfloatVariables[7].push_back(fatJetIdx);
         } 
     }
 
+    //btag SF of all selected jets
+    if(!isData){
+        for(const JetType& type: {AK4, AK8}){
+            std::vector<std::vector<float>>& variables = type == AK4 ? JetfloatVariables : FatJetfloatVariables;
+            bTagTable[type].Evaluate(bTagEta[type], bTagPt[type], bTagValues);
+
+            for(unsigned int k = 0; k < bTagColumns[type].size(); k++){
+                variables[bTagColumns[type][k]] = bTagValues[k];
+            }
+
+            bTagEta[type].clear();
+            bTagPt[type].clear();
+        }
+    }
+
     //Set HT
     if(isNANO){
         HT = *valueHT->Get();
     }
 
-    for(CutFlow& cutflow: cutflows){
-        //Check if one combination of jet and fatjet number is fullfilled
-        if(JetfloatVariables[0].size() - nSubJets >= cutflow.nMinJet and FatJetfloatVariables[0].size() == cutflow.nMinFatjet){
-            if(cutflow.passed){
-                std::string cutName("N^{AK4}_{jet} >= " + std::to_string(cutflow.nMinJet) + " && N^{AK8}_{jet} == " + std::to_string(cutflow.nMinFatjet));
+    //MET and HT of the variations, shifted by the change of the jet momenta
+    for(unsigned int v = 1; v < nVariations; v++){
+        metPxVariation[v] = metPx - metShiftX[v];
+        metPyVariation[v] = metPy - metShiftY[v];
+        HTVariation[v] = HT + HTShift[v];
+    }
 
-                cutflow.hist->Fill(cutName.c_str(), cutflow.weight);
+    if(flatOutput){
+        jetCollection.Fill(JetfloatVariables, JetboolVariables);
+        fatJetCollection.Fill(FatJetfloatVariables, FatJetboolVariables);
+        jetParticleCollection.Fill(JetParticlefloatVariables);
+        vertexCollection.Fill(VertexfloatVariables);
+    }
+
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        CutFlow& cutflow = cutflows[i];
+
+        //Check if one combination of jet and fatjet number is fullfilled, for nominal (bit 0) and each variation
+        UInt_t jetVariations = 0;
+
+        for(unsigned int v = 0; v < nVariations; v++){
+            if(nJetVariation[v] - nSubVariation[v] >= cutflow.nMinJet and nFatVariation[v] == cutflow.nMinFatjet) jetVariations |= 1 << v;
+        }
+
+        if(jetVariations & 1){
+            if(cutflow.passed){
+                cutflow.Fill(cutSteps[i]);
             }
         }
 
+        //Nominal decision only from nominal jets, variations are kept in the mask of the channel
         else{
             cutflow.passed = false;
         }
+
+        cutflow.passedVariations &= jetVariations;
     }
 }
 
 
-void JetAnalyzer::EndJob(TFile* file){
-    for(const JetType& type: {AK4, AK8}){
-        delete jetCorrector[type];
-    }
-}
+void JetAnalyzer::EndJob(TFile* file){}
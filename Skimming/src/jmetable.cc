@@ -0,0 +1,366 @@
+#include <ChargedSkimming/Skimming/interface/jmetable.h>
+#include <ChargedSkimming/Skimming/interface/calibrationcache.h>
+
+#include <sstream>
+#include <regex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+JMETable::JMETable(){}
+
+namespace {
+    //Append array to buffer, arrays are padded to 8 bytes to keep the doubles aligned
+    template<typename T>
+    void Append(std::vector<char> &buffer, const std::vector<T> &values){
+        const char* begin = reinterpret_cast<const char*>(values.data());
+        buffer.insert(buffer.end(), begin, begin + values.size()*sizeof(T));
+        buffer.resize((buffer.size() + 7)/8*8, 0);
+    }
+
+    std::string Join(const std::vector<std::string> &names){
+        std::string joined;
+
+        for(const std::string &name: names){
+            joined += (joined.empty() ? "" : " ") + name;
+        }
+
+        return joined;
+    }
+}
+
+JMETable::JMETable(const std::string &fileName){
+    std::string content = CalibrationCache::ReadFile(fileName);
+    checksum = CalibrationCache::Checksum(content);
+
+    //Use cache file of this content if another job already parsed it
+    std::shared_ptr<CalibrationCache> cache = std::make_shared<CalibrationCache>(CacheFile());
+
+    if(cache->IsOpen() and Attach(cache->Data(), cache->Size(), checksum)){
+        storage = cache;
+    }
+
+    else{
+        std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>(Parse(content, checksum));
+
+        if(!Attach(buffer->data(), buffer->size(), checksum)){
+            throw std::runtime_error("Can not parse JME file: " + fileName);
+        }
+
+        //Failing to write the cache only costs time for the next job
+        CalibrationCache::Write(CacheFile(), *buffer);
+        storage = buffer;
+    }
+
+    SetKernel();
+}
+
+std::string JMETable::CacheFile() const {
+    return CalibrationCache::Path("jmetable", checksum);
+}
+
+std::vector<char> JMETable::Parse(const std::string &content, const std::uint64_t &checksum){
+    std::istringstream file(content);
+    std::string line;
+    bool hasHeader = false;
+
+    std::vector<std::string> binVariables, parVariables;
+    std::string formulaString, type;
+    std::vector<double> binMin, binMax, parMin, parMax, params, groupMin;
+    std::vector<std::uint32_t> offsets, groupStart;
+
+    while(std::getline(file, line)){
+        //Skip empty lines and comments
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if(first == std::string::npos or line[first] == '#') continue;
+
+        //Only first section of files with several sources
+        if(line[first] == '['){
+            if(hasHeader) break;
+            else continue;
+        }
+
+        //Header in the form {nBin binVar... nPar parVar... formula ... type}
+        if(line[first] == '{'){
+            std::string header = line.substr(first + 1, line.rfind('}') - first - 1);
+            std::istringstream stream(header);
+            std::vector<std::string> tokens;
+            std::string token;
+
+            while(stream >> token) tokens.push_back(token);
+
+            unsigned int nBin = std::stoi(tokens[0]);
+            binVariables = std::vector<std::string>(tokens.begin() + 1, tokens.begin() + 1 + nBin);
+
+            unsigned int nPar = std::stoi(tokens[1 + nBin]);
+            parVariables = std::vector<std::string>(tokens.begin() + 2 + nBin, tokens.begin() + 2 + nBin + nPar);
+
+            formulaString = tokens[2 + nBin + nPar];
+            type = tokens.back();
+            hasHeader = true;
+
+            continue;
+        }
+
+        //Record in the form binMin binMax ... nValues parMin parMax ... parameters
+        std::istringstream stream(line);
+        double value;
+        unsigned int nValues;
+
+        for(unsigned int i = 0; i < binVariables.size(); i++){
+            stream >> value; binMin.push_back(value);
+            stream >> value; binMax.push_back(value);
+        }
+
+        stream >> nValues;
+
+        //Uncertainty files have no formula variable ranges
+        unsigned int nRange = type == "Uncertainty" ? 0 : parVariables.size();
+
+        for(unsigned int i = 0; i < nRange; i++){
+            stream >> value; parMin.push_back(value);
+            stream >> value; parMax.push_back(value);
+        }
+
+        offsets.push_back(params.size());
+
+        for(unsigned int i = 0; i < nValues - 2*nRange; i++){
+            stream >> value; params.push_back(value);
+        }
+    }
+
+    unsigned int nRecords = offsets.size();
+    offsets.push_back(params.size());
+
+    //Group records by lower edge of first bin variable
+    for(unsigned int record = 0; record < nRecords; record++){
+        if(record == 0 or binMin[record*binVariables.size()] != groupMin.back()){
+            groupMin.push_back(binMin[record*binVariables.size()]);
+            groupStart.push_back(record);
+        }
+    }
+
+    groupStart.push_back(nRecords);
+
+    std::string text = formulaString + "\n" + type + "\n" + Join(binVariables) + "\n" + Join(parVariables);
+
+    CacheHeader header = {{'J', 'M', 'E', 'T', 'A', 'B', 'L', 'E'}, CalibrationCache::version, (std::uint32_t)binVariables.size(), (std::uint32_t)parVariables.size(), !parMin.empty(), checksum, nRecords, params.size(), groupMin.size(), text.size()};
+
+    std::vector<char> buffer(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(header));
+    Append(buffer, std::vector<char>(text.begin(), text.end()));
+
+    for(const std::vector<double>* values: {&binMin, &binMax, &parMin, &parMax, &params, &groupMin}){
+        Append(buffer, *values);
+    }
+
+    Append(buffer, offsets);
+    Append(buffer, groupStart);
+
+    return buffer;
+}
+
+bool JMETable::Attach(const char* data, const std::size_t &size, const std::uint64_t &checksum){
+    if(size < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if(std::string(header.magic, 8) != "JMETABLE" or header.version != CalibrationCache::version or header.checksum != checksum) return false;
+
+    //Sizes of all arrays, each padded to 8 bytes
+    std::size_t nRange = header.hasRange ? header.nRecords*header.nPar : 0;
+    std::size_t sizes[9] = {header.textSize, 8*header.nRecords*header.nBin, 8*header.nRecords*header.nBin, 8*nRange, 8*nRange, 8*header.nParams, 8*header.nGroups, 4*(header.nRecords + 1), 4*(header.nGroups + 1)};
+    std::size_t starts[9];
+    std::size_t position = sizeof(header);
+
+    for(unsigned int i = 0; i < 9; i++){
+        starts[i] = position;
+        position += (sizes[i] + 7)/8*8;
+    }
+
+    //Truncated file, e.g. disk full while writing
+    if(position != size) return false;
+
+    std::istringstream text(std::string(data + starts[0], header.textSize));
+    std::string line, name;
+
+    std::getline(text, formulaString);
+    std::getline(text, type);
+
+    for(std::vector<std::string>* names: {&binVariables, &parVariables}){
+        std::getline(text, line);
+        std::istringstream stream(line);
+
+        names->clear();
+        while(stream >> name) names->push_back(name);
+    }
+
+    nRecords = header.nRecords;
+    nGroups = header.nGroups;
+
+    binMin = reinterpret_cast<const double*>(data + starts[1]);
+    binMax = reinterpret_cast<const double*>(data + starts[2]);
+    parMin = header.hasRange ? reinterpret_cast<const double*>(data + starts[3]) : NULL;
+    parMax = header.hasRange ? reinterpret_cast<const double*>(data + starts[4]) : NULL;
+    params = reinterpret_cast<const double*>(data + starts[5]);
+    groupMin = reinterpret_cast<const double*>(data + starts[6]);
+    offsets = reinterpret_cast<const std::uint32_t*>(data + starts[7]);
+    groupStart = reinterpret_cast<const std::uint32_t*>(data + starts[8]);
+
+    return true;
+}
+
+void JMETable::SetKernel(){
+    static const std::string polynomial = "max(0.0001,[0]+((x-[1])*([2]+((x-[1])*([3]+((x-[1])*[4]))))))";
+    static const std::string residual = "[2]*([3]*([4]+[5]*TMath::Log(max([0],min([1],x))))*1./([6]+[7]*100./3.*(TMath::Max(0.,1.03091-0.051154*pow(x,-0.154227))-TMath::Max(0.,1.03091-0.051154*TMath::Power(208.,-0.154227)))+[8]*0.021*(-1.+1./(1.+exp(-(TMath::Log(x)-5.030)/0.395)))))";
+    static const std::string resolution = "sqrt([0]*abs([0])/(x*x)+[1]*[1]*pow(x,[3])+[2]*[2])";
+
+    if(formulaString == "1") kernel = CONSTANT;
+    else if(formulaString == "None" or formulaString == "\"\"") kernel = PARAMETERS;
+    else if(formulaString == polynomial) kernel = POLYNOMIAL;
+    else if(formulaString == residual) kernel = RESIDUAL;
+    else if(formulaString == resolution) kernel = RESOLUTION;
+
+    else{
+        //L1FastJet formulas only differ in the rho and pt offsets
+        std::smatch rhoMatch, ptMatch;
+        std::regex_search(formulaString, rhoMatch, std::regex("\\(x-([0-9.]+)\\)"));
+        std::regex_search(formulaString, ptMatch, std::regex("log\\(y/([0-9.]+)\\)"));
+
+        if(!rhoMatch.empty() and !ptMatch.empty()){
+            std::string rho = "(x-" + rhoMatch[1].str() + ")", logPt = "log(y/" + ptMatch[1].str() + ")";
+            std::string l1 = "max(0.0001,1-(z/y)*([0]+[1]*" + rho + "+[2]*" + logPt + "+[3]*pow(" + logPt + ",2)+[4]*" + rho + "*" + logPt + "+[5]*" + rho + "*pow(" + logPt + ",2)))";
+
+            if(formulaString == l1){
+                kernel = L1FASTJET;
+                offsetX = std::stod(rhoMatch[1].str());
+                scaleY = std::stod(ptMatch[1].str());
+
+                return;
+            }
+        }
+
+        //Not known formula, fall back to TFormula without registering it globally
+        kernel = FORMULA;
+        formula = std::make_shared<TFormula>("jmeFormula", formulaString.c_str(), false);
+    }
+}
+
+unsigned int JMETable::NRecords() const {
+    return nRecords;
+}
+
+const std::vector<std::string>& JMETable::BinVariables() const {
+    return binVariables;
+}
+
+const std::vector<std::string>& JMETable::ParVariables() const {
+    return parVariables;
+}
+
+const std::string& JMETable::Type() const {
+    return type;
+}
+
+JMETable::Kernel JMETable::GetKernel() const {
+    return kernel;
+}
+
+int JMETable::FindBin(const double* binValues) const {
+    unsigned int nBin = binVariables.size();
+
+    //Group is last one starting below the value of the first bin variable
+    const double* group = std::upper_bound(groupMin, groupMin + nGroups, binValues[0]);
+    if(group == groupMin) return -1;
+
+    unsigned int index = group - groupMin - 1;
+
+    for(unsigned int record = groupStart[index]; record < groupStart[index + 1]; record++){
+        bool inside = true;
+
+        //Same convention as JetCorrectorParameters: min <= x < max
+        for(unsigned int i = 0; i < nBin; i++){
+            if(binValues[i] < binMin[record*nBin + i] or binValues[i] >= binMax[record*nBin + i]){
+                inside = false;
+                break;
+            }
+        }
+
+        if(inside) return record;
+    }
+
+    return -1;
+}
+
+const double* JMETable::Parameters(const int &record) const {
+    return params + offsets[record];
+}
+
+unsigned int JMETable::NParameters(const int &record) const {
+    return offsets[record + 1] - offsets[record];
+}
+
+double JMETable::Evaluate(const int &record, const double* parValues) const {
+    const double* p = Parameters(record);
+    double x[3] = {0., 0., 0.};
+
+    for(unsigned int i = 0; i < parVariables.size() and i < 3; i++){
+        x[i] = parValues[i];
+
+        if(parMin != NULL){
+            x[i] = std::min(std::max(x[i], parMin[record*parVariables.size() + i]), parMax[record*parVariables.size() + i]);
+        }
+    }
+
+    switch(kernel){
+        case CONSTANT: return 1.;
+
+        case PARAMETERS: return p[0];
+
+        case L1FASTJET: {
+            double dRho = x[0] - offsetX, logPt = std::log(x[1]/scaleY);
+
+            return std::max(0.0001, 1 - (x[2]/x[1])*(p[0] + p[1]*dRho + p[2]*logPt + p[3]*logPt*logPt + p[4]*dRho*logPt + p[5]*dRho*logPt*logPt));
+        }
+
+        case POLYNOMIAL: {
+            double dx = x[0] - p[1];
+
+            return std::max(0.0001, p[0] + dx*(p[2] + dx*(p[3] + dx*p[4])));
+        }
+
+        case RESIDUAL: {
+            double offset = std::max(0., 1.03091 - 0.051154*std::pow(208., -0.154227));
+            double fraction = std::max(0., 1.03091 - 0.051154*std::pow(x[0], -0.154227)) - offset;
+            double sigmoid = -1. + 1./(1. + std::exp(-(std::log(x[0]) - 5.030)/0.395));
+
+            return p[2]*(p[3]*(p[4] + p[5]*std::log(std::max(p[0], std::min(p[1], x[0]))))*1./(p[6] + p[7]*100./3.*fraction + p[8]*0.021*sigmoid));
+        }
+
+        case RESOLUTION: return std::sqrt(p[0]*std::abs(p[0])/(x[0]*x[0]) + p[1]*p[1]*std::pow(x[0], p[3]) + p[2]*p[2]);
+
+        case FORMULA: return formula->EvalPar(x, p);
+    }
+
+    return 1.;
+}
+
+double JMETable::Uncertainty(const int &record, const double &x, const bool &up) const {
+    const double* p = Parameters(record);
+    unsigned int nNodes = NParameters(record)/3;
+    unsigned int column = up ? 1 : 2;
+
+    if(nNodes == 0) return 0.;
+    if(x <= p[0]) return p[column];
+    if(x >= p[3*(nNodes - 1)]) return p[3*(nNodes - 1) + column];
+
+    //Same as SimpleJetCorrectionUncertainty
+    unsigned int node = 0;
+    while(p[3*(node + 1)] <= x) node++;
+
+    const double* low = p + 3*node;
+    const double* high = low + 3;
+
+    return low[column] + (x - low[0])*(high[column] - low[column])/(high[0] - low[0]);
+}
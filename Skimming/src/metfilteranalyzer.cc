@@ -4,13 +4,12 @@ MetFilterAnalyzer::MetFilterAnalyzer(const int &era, TTreeReader &reader):
     BaseAnalyzer(&reader),
     era(era){}
 
-MetFilterAnalyzer::MetFilterAnalyzer(const int &era, trigToken& triggerToken):
+MetFilterAnalyzer::MetFilterAnalyzer(const int &era):
     BaseAnalyzer(),
-    era(era),
-    triggerToken(triggerToken)
+    era(era)
     {}
 
-void MetFilterAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
+void MetFilterAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
     //Set Filter names for each era
     filterNames = {
                 {2017, {"Flag_goodVertices",
@@ -24,58 +23,60 @@ void MetFilterAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
                  },
     };
 
+    filterIndex = TriggerPathIndex(filterNames[era]);
+
     if(isNANO){
         //Set TTreeReaderValues
         for(std::string filterName: filterNames[era]){
-            filterValues.push_back(std::make_unique<TTreeReaderValue<bool>>(*reader, filterName.c_str()));
+            filterValues.push_back(input->Value<bool>(filterName));
         }
     }
+
+    for(CutFlow& cutflow: cutflows){
+        cutSteps.push_back(cutflow.AddStep("Met filter"));
+    }
 }
 
-void MetFilterAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
+void MetFilterAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     bool passedFilter = true;
 
     //Get Event info is using MINIAOD
     edm::Handle<edm::TriggerResults> triggers;
 
     if(!isNANO){
-        event->getByToken(triggerToken, triggers);
-        const edm::TriggerNames &names = event->triggerNames(*triggers);
+        triggers = context->Triggers();
+        const edm::TriggerNames &names = context->TriggerNames();
 
-        //Find result with given filter name with MINIAOD
-        for(std::string filterName: filterNames[era]){
-            std::vector<int> filterVersion; 
-
-            for(unsigned int i = 0; i < names.size(); i++){
-                if(names.triggerName(i).find(filterName) != std::string::npos){
-                    filterVersion.push_back(triggers->accept(i));
-                }
-            }    
-    
-            if(filterVersion.size() != 0){
-                passedFilter *= filterVersion.back();
-            }    
+        //Result with given filter name with MINIAOD, filters not in the menu are ignored
+        filterIndex.Update(names);
+
+        for(unsigned int i = 0; i < filterNames[era].size(); i++){
+            int accept = filterIndex.Accept(i, *triggers);
+
+            if(accept != -1){
+                passedFilter *= accept;
+            }
         }
     }
 
     else{
         //Filter result in NANOAOD
-        for(std::unique_ptr<TTreeReaderValue<bool>> &filter: filterValues){
+        for(std::shared_ptr<InputValue<bool>> &filter: filterValues){
             passedFilter *= *filter->Get();
         }
     }
 
     if(passedFilter){
-        for(CutFlow& cutflow: cutflows){
-            if(cutflow.passed){
-                cutflow.hist->Fill("Met filter", cutflow.weight);        
+        for(unsigned int i = 0; i < cutflows.size(); i++){
+            if(cutflows[i].passed){
+                cutflows[i].Fill(cutSteps[i]);
             }
         }
     }
 
     else{
         for(CutFlow& cutflow: cutflows){     
-            cutflow.passed = false;
+            cutflow.Reject();
         }
     }
 }
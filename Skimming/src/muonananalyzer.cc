@@ -7,17 +7,14 @@ MuonAnalyzer::MuonAnalyzer(const int &era, const float &ptCut, const float &etaC
     etaCut(etaCut)
     {}
 
-MuonAnalyzer::MuonAnalyzer(const int &era, const float &ptCut, const float &etaCut, muToken& muonToken, trigObjToken& triggerObjToken, genPartToken& genParticleToken):
+MuonAnalyzer::MuonAnalyzer(const int &era, const float &ptCut, const float &etaCut):
     BaseAnalyzer(), 
     era(era),
     ptCut(ptCut),
-    etaCut(etaCut),
-    muonToken(muonToken),
-    triggerObjToken(triggerObjToken),
-    genParticleToken(genParticleToken)
+    etaCut(etaCut)
     {}
 
-void MuonAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
+void MuonAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
     isoSFfiles = {
         {2017, filePath + "/muonSF/RunBCDEF_SF_ISO.root"},
     };
@@ -33,32 +30,28 @@ void MuonAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     //Set data bool
     this->isData = isData;
 
-    //Hist with scale factors
-    TFile* triggerSFfile = TFile::Open(triggerSFfiles[era].c_str());
-    triggerSFhist = (TH2F*)triggerSFfile->Get("IsoMu27_PtEtaBins/pt_abseta_ratio");
+    //Scale factors, files are closed after copying the histograms
+    triggerSF = ScaleFactorTable(triggerSFfiles[era], "IsoMu27_PtEtaBins/pt_abseta_ratio");
 
-    TFile* isoSFfile = TFile::Open(isoSFfiles[era].c_str());
-    IsoHist.push_back((TH2F*)isoSFfile->Get("NUM_LooseRelIso_DEN_LooseID_pt_abseta"));
-    IsoHist.push_back((TH2F*)isoSFfile->Get("NUM_TightRelIso_DEN_TightIDandIPCut_pt_abseta"));
+    isoSF = {
+        ScaleFactorTable(isoSFfiles[era], "NUM_LooseRelIso_DEN_LooseID_pt_abseta"),
+        ScaleFactorTable(isoSFfiles[era], "NUM_TightRelIso_DEN_TightIDandIPCut_pt_abseta"),
+    };
 
-    TFile* IDSFfile = TFile::Open(IDSFfiles[era].c_str());
-    IDHist.push_back((TH2F*)IDSFfile->Get("NUM_LooseID_DEN_genTracks_pt_abseta"));
-    IDHist.push_back((TH2F*)IDSFfile->Get("NUM_TightID_DEN_genTracks_pt_abseta"));
+    IDSF = {
+        ScaleFactorTable(IDSFfiles[era], "NUM_LooseID_DEN_genTracks_pt_abseta"),
+        ScaleFactorTable(IDSFfiles[era], "NUM_TightID_DEN_genTracks_pt_abseta"),
+    };
 
     if(isNANO){
         //Initiliaze TTreeReaderValues
-        muonPt = std::make_unique<TTreeReaderArray<float>>(*reader, "Muon_pt");
-        muonEta = std::make_unique<TTreeReaderArray<float>>(*reader, "Muon_eta");
-        muonPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "Muon_phi");
-        muonCharge = std::make_unique<TTreeReaderArray<int>>(*reader, "Muon_charge");
-        muonIso = std::make_unique<TTreeReaderArray<float>>(*reader, "Muon_miniPFRelIso_all");
-        muonLooseID = std::make_unique<TTreeReaderArray<bool>>(*reader, "Muon_looseId");
-        muonTightID = std::make_unique<TTreeReaderArray<bool>>(*reader, "Muon_tightId");
-
-        if(!this->isData){
-            muonGenIdx = std::make_unique<TTreeReaderArray<int>>(*reader, "Muon_genPartIdx");
-        }
-
+        muonPt = input->Array<float>("Muon_pt");
+        muonEta = input->Array<float>("Muon_eta");
+        muonPhi = input->Array<float>("Muon_phi");
+        muonCharge = input->Array<int>("Muon_charge");
+        muonIso = input->Array<float>("Muon_miniPFRelIso_all");
+        muonLooseID = input->Array<bool>("Muon_looseId");
+        muonTightID = input->Array<bool>("Muon_tightId");
 
         //Set TTreeReader for genpart and trigger obj from baseanalyzer
         SetCollection(this->isData);
@@ -68,22 +61,38 @@ void MuonAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     floatNames = {"E", "Px", "Py", "Pz", "Charge", "looseIsoLooseSF", "tightIsoTightSF", "looseSF", "tightSF", "triggerSF"};
     boolNames = {"isLooseIso", "isTightIso", "isLoose", "isTight", "isTriggerMatched", "isFromHc"};
 
+    //Uncertainties of the scale factors
+    if(systematics and !this->isData){
+        floatNames.insert(floatNames.end(), {"looseIsoLooseSFUnc", "tightIsoTightSFUnc", "looseSFUnc", "tightSFUnc", "triggerSFUnc"});
+    }
+
     floatVariables = std::vector<std::vector<float>>(floatNames.size(), std::vector<float>());
     boolVariables = std::vector<std::vector<bool>>(boolNames.size(), std::vector<bool>());
 
     //Set Branches of output tree
-    for(TTree* tree: trees){
-        for(unsigned int i=0; i<floatVariables.size(); i++){
-            tree->Branch(("Muon_" + floatNames[i]).c_str(), &floatVariables[i]);
-        }
+    if(flatOutput){
+        muonCollection = FlatCollection("Muon", floatNames, boolNames);
+        muonCollection.Branch(trees);
+    }
 
-        for(unsigned int i=0; i<boolVariables.size(); i++){
-            tree->Branch(("Muon_" + boolNames[i]).c_str(), &boolVariables[i]);
+    else{
+        for(TTree* tree: trees){
+            for(unsigned int i=0; i<floatVariables.size(); i++){
+                tree->Branch(("Muon_" + floatNames[i]).c_str(), &floatVariables[i]);
+            }
+
+            for(unsigned int i=0; i<boolVariables.size(); i++){
+                tree->Branch(("Muon_" + boolNames[i]).c_str(), &boolVariables[i]);
+            }
         }
     }
+
+    for(CutFlow &cutflow: cutflows){
+        cutSteps.push_back(cutflow.nMinMu!=0 ? cutflow.AddStep("N_{#mu} >= " + std::to_string(cutflow.nMinMu) + " (no iso/ID req)") : 0);
+    }
 }
 
-void MuonAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
+void MuonAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     //Clear variables vector
     for(std::vector<float>& variable: floatVariables){
         variable.clear();
@@ -99,8 +108,9 @@ void MuonAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* eve
     edm::Handle<std::vector<reco::GenParticle>> genParts;
 
     if(!isNANO){
-        event->getByToken(muonToken, muons);
-        event->getByToken(triggerObjToken, trigObjects);
+        muons = context->Muons();
+        trigObjects = context->TriggerObjects();
+        if(!isData) genParts = context->GenParticles();
     }
 
     float muSize = isNANO ? muonPt->GetSize() : muons->size();
@@ -112,8 +122,7 @@ void MuonAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* eve
         float phi = isNANO ? muonPhi->At(i) : muons->at(i).phi();
 
         if(pt > ptCut && abs(eta) < etaCut){
-            TLorentzVector lVec;
-            lVec.SetPtEtaPhiM(pt, eta, phi, 105.658*1e-3);
+            FourVector lVec = FourVector::PtEtaPhiM(pt, eta, phi, 105.658*1e-3);
 
             //Muon four momentum components
             floatVariables[0].push_back(lVec.E());   //Energy
@@ -129,43 +138,59 @@ void MuonAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* eve
 
             boolVariables[2].push_back(isNANO ? muonLooseID->At(i) : muons->at(i).passed(reco::Muon::CutBasedIdLoose));
             boolVariables[3].push_back(isNANO ? muonTightID->At(i) : muons->at(i).passed(reco::Muon::CutBasedIdTight));
-            boolVariables[4].push_back(isNANO ? triggerMatching(lVec) : triggerMatching(lVec, *trigObjects));
+            boolVariables[4].push_back(isNANO ? triggerMatching(lVec, TriggerObjectIndex::MUON) : triggerMatching(lVec, TriggerObjectIndex::MUON, *trigObjects));
             
             if(!isData){
                 //Scale factors
-                floatVariables[5].push_back(IsoHist[0]->GetBinContent(IsoHist[0]->FindBin(pt, abs(eta))));
-                floatVariables[6].push_back(IsoHist[1]->GetBinContent(IsoHist[1]->FindBin(pt, abs(eta))));
-
-                floatVariables[7].push_back(IDHist[0]->GetBinContent(IDHist[0]->FindBin(pt, abs(eta))));
-                floatVariables[8].push_back(IDHist[1]->GetBinContent(IDHist[1]->FindBin(pt, abs(eta))));
-
-
-                floatVariables[9].push_back(triggerSFhist->GetBinContent(triggerSFhist->FindBin(pt, abs(eta))));
+                ScaleFactorTable::ScaleFactor SFs[5] = {
+                    isoSF[0].Get(pt, abs(eta)),
+                    isoSF[1].Get(pt, abs(eta)),
+                    IDSF[0].Get(pt, abs(eta)),
+                    IDSF[1].Get(pt, abs(eta)),
+                    triggerSF.Get(pt, abs(eta)),
+                };
+
+                for(unsigned int j = 0; j < 5; j++){
+                    floatVariables[5 + j].push_back(SFs[j].value);
+                    if(systematics) floatVariables[10 + j].push_back(SFs[j].error);
+                }
 
                 //Save gen particle information
                 if(isNANO) boolVariables[5].push_back(SetGenParticles(lVec, i, 13));
-                else{
-                    event->getByToken(genParticleToken, genParts);
-                    boolVariables[5].push_back(SetGenParticles(lVec, i, 13, *genParts));
-                }
+                else boolVariables[5].push_back(SetGenParticles(lVec, i, 13, *genParts));
              }
         } 
     }
     
+    if(flatOutput) muonCollection.Fill(floatVariables, boolVariables);
+
     //Check if event has enough electrons
-    for(CutFlow &cutflow: cutflows){
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        CutFlow &cutflow = cutflows[i];
+
         if(cutflow.nMinMu <= floatVariables[0].size()){
             if(cutflow.nMinMu!=0 and cutflow.passed){
-                std::string cutName("N_{#mu} >= " + std::to_string(cutflow.nMinMu) + " (no iso/ID req)");
-                cutflow.hist->Fill(cutName.c_str(), cutflow.weight);
+                cutflow.Fill(cutSteps[i]);
             }
         }
 
         else{
-            cutflow.passed = false;
+            cutflow.Reject();
         }
     }
 }
 
+void MuonAnalyzer::Clear(){
+    for(std::vector<float>& variable: floatVariables){
+        variable.clear();
+    }
+
+    for(std::vector<bool>& variable: boolVariables){
+        variable.clear();
+    }
+
+    if(flatOutput) muonCollection.Fill(floatVariables, boolVariables);
+}
+
 void MuonAnalyzer::EndJob(TFile* file){
 }
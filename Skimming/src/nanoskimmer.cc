@@ -7,17 +7,56 @@
 #include <ChargedSkimming/Skimming/interface/jetanalyzer.h>
 #include <ChargedSkimming/Skimming/interface/genpartanalyzer.h>
 #include <ChargedSkimming/Skimming/interface/weightanalyzer.h>
+#include <ChargedSkimming/Skimming/interface/preselectionanalyzer.h>
+
+#include <thread>
+#include <cstdio>
+#include <algorithm>
+
+#include <TROOT.h>
 
 NanoSkimmer::NanoSkimmer(){}
 
-NanoSkimmer::NanoSkimmer(const std::string &inFile, const bool &isData):
+NanoSkimmer::NanoSkimmer(const std::string &inFile, const std::string &outFile, const bool &isData, const int &nThreads):
     inFile(inFile),
-    isData(isData)
+    outFile(outFile),
+    isData(isData),
+    nThreads(nThreads)
     {    
         start = std::chrono::steady_clock::now();
         std::cout << "Input file for analysis: " + inFile << std::endl;
     }
 
+void NanoSkimmer::SetOutputOptions(const Long64_t &autoFlush, const Long64_t &autoSave, const int &maxMemory){
+    this->autoFlush = autoFlush;
+    this->autoSave = autoSave;
+    this->maxMemory = maxMemory;
+}
+
+void NanoSkimmer::SetSingleTree(const bool &singleTree){
+    this->singleTree = singleTree;
+}
+
+void NanoSkimmer::SetStagedRead(const bool &stagedRead){
+    this->stagedRead = stagedRead;
+}
+
+void NanoSkimmer::SetFlatOutput(const bool &flatOutput){
+    this->flatOutput = flatOutput;
+}
+
+void NanoSkimmer::SetSystematics(const bool &systematics){
+    this->systematics = systematics;
+}
+
+void NanoSkimmer::SetPerformanceReport(const bool &performanceReport){
+    this->performanceReport = performanceReport;
+}
+
+void NanoSkimmer::SetSkipAnalyzers(const bool &skipAnalyzers){
+    this->skipAnalyzers = skipAnalyzers;
+}
+
 void NanoSkimmer::ProgressBar(const int &progress){
     std::string progressBar = "["; 
 
@@ -36,8 +75,8 @@ void NanoSkimmer::ProgressBar(const int &progress){
 
 }
 
-void NanoSkimmer::Configure(const float &xSec, TTreeReader& reader){
-    analyzers = {
+std::vector<std::shared_ptr<BaseAnalyzer>> NanoSkimmer::Configure(const float &xSec, TTreeReader& reader){
+    std::vector<std::shared_ptr<BaseAnalyzer>> analyzers = {
         std::shared_ptr<WeightAnalyzer>(new WeightAnalyzer(2017, xSec, reader)),
 //        std::shared_ptr<TriggerAnalyzer>(new TriggerAnalyzer({"HLT_IsoMu27"}, triggerToken)),
   //      std::shared_ptr<TriggerAnalyzer>(new TriggerAnalyzer({"HLT_Ele35_WPTight_Gsf", "HLT_Ele28_eta2p1_WPTight_Gsf_HT150", "HLT_Ele30_eta2p1_WPTight_Gsf_CentralPFJet35_EleCleaned"}, triggerToken)),
@@ -47,123 +86,328 @@ void NanoSkimmer::Configure(const float &xSec, TTreeReader& reader){
         std::shared_ptr<ElectronAnalyzer>(new ElectronAnalyzer(2017, 20., 2.4, reader)),
         std::shared_ptr<GenPartAnalyzer>(new GenPartAnalyzer(reader))
     };
+
+    //TTreeReader only reads branches which are accessed, so events failing the counter check never load the collections
+    if(stagedRead){
+        analyzers.insert(analyzers.begin() + 2, std::shared_ptr<PreselectionAnalyzer>(new PreselectionAnalyzer(reader)));
+    }
+
+    return analyzers;
 }
 
-void NanoSkimmer::EventLoop(const std::vector<std::string> &channels, const float &xSec){
+std::vector<std::pair<Long64_t, Long64_t>> NanoSkimmer::EntryRanges(TTree* tree, const int &nRanges){
+    std::vector<std::pair<Long64_t, Long64_t>> ranges;
+
+    //Only split at cluster boundaries, so no basket is decompressed by two workers
+    std::vector<Long64_t> boundaries = {0};
+    TTree::TClusterIterator clusterIt = tree->GetClusterIterator(0);
 
-    //TTreeReader preperation
+    while(clusterIt() < nEntries){
+        boundaries.push_back(clusterIt.GetNextEntry());
+    }
+
+    if(boundaries.back() != nEntries) boundaries.push_back(nEntries);
+
+    //Fill ranges with clusters until each range has its share of the entries
+    Long64_t first = 0;
+
+    for(unsigned int i = 1; i < boundaries.size(); i++){
+        Long64_t target = nEntries*(ranges.size() + 1)/nRanges;
+
+        if(boundaries[i] >= target or i == boundaries.size() - 1){
+            ranges.push_back({first, boundaries[i]});
+            first = boundaries[i];
+        }
+    }
+
+    return ranges;
+}
+
+void NanoSkimmer::EventLoop(const std::vector<std::string> &channels, const float &xSec){
+    //Get entry ranges for each worker
     TFile* inputFile = TFile::Open(inFile.c_str(), "READ");
     TTree* eventTree = (TTree*)inputFile->Get("Events");
-    TTreeReader reader(eventTree);
+    nEntries = eventTree->GetEntries();
 
-    Configure(xSec, reader);
+    std::vector<std::pair<Long64_t, Long64_t>> ranges = {{0, nEntries}};
+    if(nThreads > 1){
+        ranges = EntryRanges(eventTree, nThreads);
+        if(ranges.empty()) ranges = {{0, nEntries}};
 
-    nMin = {
-            {"mu4j", {1, 0, 4, 0}},
-            {"e4j", {0, 1, 4, 0}},
-            {"mu2j1f", {1, 0, 2, 1}},
-            {"e2j1f", {0, 1, 2, 1}},
-            {"mu2f", {1, 0, 0, 2}},
-            {"e2f", {0, 1, 0, 2}},
-    };
+        ROOT::EnableThreadSafety();
+    }
+
+    inputFile->Close();
 
-    for(const std::string &channel: channels){
-        //Create output trees
-        TTree* tree = new TTree();
-        tree->SetName(channel.c_str());
-        outputTrees.push_back(tree);
+    //Set up workers one after another, so file opening and analyzer configuration stay serial
+    workers = std::vector<SkimWorker>(ranges.size());
 
-        //Create cutflow histograms
-        CutFlow cutflow;
+    //Channel bits are stored in one byte
+    if(singleTree and channels.size() > 8){
+        std::cout << "Single output tree supports at most 8 channels, write one tree per channel" << std::endl;
+        singleTree = false;
+    }
 
-        cutflow.hist = new TH1F();
-        cutflow.hist->SetName(("cutflow_" + channel).c_str());
-        cutflow.hist->SetName(("cutflow_" + channel).c_str());
-        cutflow.hist->GetYaxis()->SetName("Events");
+    std::vector<std::string> treeNames = singleTree ? std::vector<std::string>{"Events"} : channels;
 
-        cutflow.nMinMu=nMin[channel][0];
-        cutflow.nMinEle=nMin[channel][1];
-        cutflow.nMinJet=nMin[channel][2];
-        cutflow.nMinFatjet=nMin[channel][3];
-        
-        cutflow.weight = 1;    
+    //Memory budget shared by all output trees, flush baskets before a tree exceeds its share
+    Long64_t flushBytes = -Long64_t(maxMemory)*1024*1024/Long64_t(workers.size()*treeNames.size());
+    if(autoFlush < 0) flushBytes = std::max(flushBytes, autoFlush);
 
-        cutflows.push_back(cutflow); 
-    }
+    for(unsigned int w = 0; w < workers.size(); w++){
+        SkimWorker& worker = workers[w];
+
+        //TTreeReader preperation
+        worker.inputFile = TFile::Open(inFile.c_str(), "READ");
+        worker.reader = std::make_unique<TTreeReader>((TTree*)worker.inputFile->Get("Events"));
+        worker.input = std::make_shared<InputColumns>(*worker.reader);
+        worker.firstEntry = ranges[w].first;
+        worker.lastEntry = ranges[w].second;
+
+        worker.analyzers = Configure(xSec, *worker.reader);
 
-    //Begin jobs for all analyzers
-    for(std::shared_ptr<BaseAnalyzer> analyzer: analyzers){
-        analyzer->BeginJob(outputTrees, isData);
+        std::vector<std::string> analyzerNames;
+        for(std::shared_ptr<BaseAnalyzer> analyzer: worker.analyzers) analyzerNames.push_back(PerformanceMonitor::TypeName(typeid(*analyzer)));
+        worker.monitor = PerformanceMonitor(analyzerNames);
+
+        //Other workers write into temporary files which are appended in WriteOutput
+        worker.outputName = w == 0 ? outFile : outFile.substr(0, outFile.rfind(".root")) + "_thread" + std::to_string(w) + ".root";
+        worker.outputFile = TFile::Open(worker.outputName.c_str(), "RECREATE");
+
+        for(const std::string &treeName: treeNames){
+            //Create output trees, attached to output file so baskets are written while filling
+            TTree* tree = new TTree();
+            tree->SetName(treeName.c_str());
+            tree->SetDirectory(worker.outputFile);
+            tree->SetAutoFlush(autoFlush < 0 ? flushBytes : autoFlush);
+            tree->SetAutoSave(autoSave);
+            worker.outputTrees.push_back(tree);
+        }
+
+        if(singleTree){
+            TTree* tree = worker.outputTrees[0];
+            tree->Branch("channelMask", &worker.channelMask, "channelMask/b");
+
+            //Select channel in the output with e.g. tree->Draw("...", "mu4j")
+            for(unsigned int i = 0; i < channels.size(); i++){
+                tree->SetAlias(channels[i].c_str(), ("(channelMask & " + std::to_string(1 << i) + ") != 0").c_str());
+            }
+        }
+
+        //Create cutflow of each channel
+        worker.cutflows = CutFlow::Channels(channels);
+
+        //Channel decision of each JES/JER variation, events only passing in a variation are written too
+        if(systematics and !isData){
+            for(unsigned int i = 0; i < channels.size(); i++){
+                TTree* tree = singleTree ? worker.outputTrees[0] : worker.outputTrees[i];
+                tree->Branch(("variations_" + channels[i]).c_str(), &worker.cutflows[i].passedVariations, ("variations_" + channels[i] + "/i").c_str());
+            }
+        }
+
+        //Begin jobs for all analyzers
+        for(std::shared_ptr<BaseAnalyzer> analyzer: worker.analyzers){
+            analyzer->SetFlatOutput(flatOutput);
+            analyzer->SetSystematics(systematics);
+            analyzer->SetTriggerObjects(worker.triggerObjects);
+            analyzer->SetGenealogy(worker.genealogy);
+            analyzer->SetInput(worker.input);
+            analyzer->BeginJob(worker.outputTrees, isData, worker.cutflows);
+            worker.channelMasks.push_back(analyzer->ChannelMask(worker.cutflows));
+        }
     }
 
     //Progress bar at 0%
-    int processed = 0;
+    std::atomic<Long64_t> processed(0);
+    std::mutex progressMutex;
     ProgressBar(0.);
 
+    PerformanceMonitor::Clock::time_point loopStart = PerformanceMonitor::Now();
+
+    if(workers.size() == 1){
+        Process(workers[0], processed, progressMutex);
+    }
+
+    else{
+        std::vector<std::thread> threads;
+
+        for(SkimWorker& worker: workers){
+            threads.push_back(std::thread(&NanoSkimmer::Process, this, std::ref(worker), std::ref(processed), std::ref(progressMutex)));
+        }
+
+        for(std::thread& thread: threads){
+            thread.join();
+        }
+    }
+
+    loopTime = PerformanceMonitor::Seconds(loopStart);
+    ProgressBar(100);
+
+    //Print stats
+    for(unsigned int i = 0; i < channels.size(); i++){
+        Long64_t nSelected = 0;
+
+        for(SkimWorker& worker: workers){
+            nSelected += worker.cutflows[i].nPassed;
+        }
+
+        std::cout << channels[i] << " analysis: Selected " << nSelected << " events of " << nEntries << " (" << 100*(float)nSelected/nEntries << "%)" << std::endl;
+    }
+}
+
+void NanoSkimmer::Process(SkimWorker& worker, std::atomic<Long64_t> &processed, std::mutex &progressMutex){
+    TTreeReader& reader = *worker.reader;
+    reader.SetEntriesRange(worker.firstEntry, worker.lastEntry);
+
+    PerformanceMonitor& monitor = worker.monitor;
+    PerformanceMonitor::Clock::time_point time = PerformanceMonitor::Now();
+
     while(reader.Next()){
+        monitor.AddRead(PerformanceMonitor::Seconds(time));
+
+        worker.triggerObjects->Clear();
+        worker.genealogy->Clear();
+
+        //Bit i set if i-th channel is still passing in nominal or a variation
+        unsigned int passedMask = (1 << worker.cutflows.size()) - 1;
+
         //Call each analyzer
-        for(unsigned int i = 0; i < analyzers.size(); i++){
+        for(unsigned int i = 0; i < worker.analyzers.size(); i++){
             unsigned int nFailed = 0;
-            analyzers[i]->Analyze(cutflows);
 
-            //If for all channels one analyzer failes, reject event
-        for(CutFlow &cutflow: cutflows){
-                if(!cutflow.passed) nFailed++;
+            if(skipAnalyzers and (worker.channelMasks[i] & passedMask) == 0){
+                worker.analyzers[i]->Clear();
+                continue;
             }
 
+            time = PerformanceMonitor::Now();
+            worker.analyzers[i]->Analyze(worker.cutflows);
+
+            for(unsigned int j = 0; j < worker.cutflows.size(); j++){
+                if(!worker.cutflows[j].Keep()){
+                    nFailed++;
+                    passedMask &= ~(1 << j);
+                }
+            }
+
+            monitor.AddAnalyzer(i, PerformanceMonitor::Seconds(time), nFailed == worker.cutflows.size());
+
             //If for all channels one analyzer failes, reject event
-            if(nFailed == cutflows.size()){
+            if(nFailed == worker.cutflows.size()){
                 break;
             }       
         }
 
         //Check individual for each channel, if event should be filled
-        for(unsigned int i = 0; i < outputTrees.size(); i++){
-            if(cutflows[i].passed){
-                outputTrees[i]->Fill();
+        time = PerformanceMonitor::Now();
+        worker.channelMask = 0;
+
+        //Nominal decision is counted and stored in the channel mask, events passing only in a variation are written as well
+        bool keep = false;
+
+        for(unsigned int i = 0; i < worker.cutflows.size(); i++){
+            if(worker.cutflows[i].passed){
+                worker.cutflows[i].nPassed++;
+                worker.channelMask |= 1 << i;
             }
 
-            cutflows[i].passed = true;
+            if(worker.cutflows[i].Keep()){
+                keep = true;
+                if(!singleTree) worker.outputTrees[i]->Fill();
+            }
         }
-        
+
+        //Event is written once if it passed any channel
+        if(singleTree and keep){
+            worker.outputTrees[0]->Fill();
+        }
+
+        for(CutFlow &cutflow: worker.cutflows) cutflow.Reset();
+
+        monitor.AddFill(PerformanceMonitor::Seconds(time));
+        monitor.AddEvent();
+    
         //progress bar
-        processed++;
-        if(processed % 10000 == 0){
-            int progress = 100*(float)processed/eventTree->GetEntries();
+        if(++processed % 10000 == 0){
+            std::lock_guard<std::mutex> lock(progressMutex);
+            int progress = 100*(float)processed/nEntries;
             ProgressBar(progress);        
         }
+
+        //Time until next entry is loaded is counted as read time
+        time = PerformanceMonitor::Now();
     }
+}
 
-    ProgressBar(100);
+void NanoSkimmer::WriteOutput(){
+    SkimWorker& merged = workers[0];
 
-    //Print stats
-    for(TTree* tree: outputTrees){
-        std::cout << tree->GetName() << " analysis: Selected " << tree->GetEntries() << " events of " << eventTree->GetEntries() << " (" << 100*(float)tree->GetEntries()/eventTree->GetEntries() << "%)" << std::endl;
+    //Merge cutflows and analyzer results of the other workers into the first one
+    for(unsigned int w = 1; w < workers.size(); w++){
+        for(unsigned int i = 0; i < merged.analyzers.size(); i++){
+            merged.analyzers[i]->Merge(workers[w].analyzers[i]);
+        }
+
+        for(unsigned int i = 0; i < merged.cutflows.size(); i++){
+            merged.cutflows[i].Merge(workers[w].cutflows[i]);
+        }
+
+        merged.monitor.Merge(workers[w].monitor);
+
+        //Finish temporary output, closing the file deletes the trees
+        workers[w].outputFile->cd();
+
+        for(TTree* tree: workers[w].outputTrees){
+            tree->Write();
+        }
+
+        workers[w].outputFile->Close();
     }
-}
 
-void NanoSkimmer::WriteOutput(const std::string &outFile){
-    TFile* file = TFile::Open(outFile.c_str(), "RECREATE");
+    //Append trees of other workers in entry order, baskets are copied without decompressing
+    for(unsigned int w = 1; w < workers.size(); w++){
+        TFile* file = TFile::Open(workers[w].outputName.c_str(), "READ");
+
+        for(TTree* tree: merged.outputTrees){
+            TTree* otherTree = (TTree*)file->Get(tree->GetName());
+            tree->CopyEntries(otherTree, -1, "fast");
+        }
+
+        file->Close();
+        std::remove(workers[w].outputName.c_str());
+    }
+
+    TFile* file = merged.outputFile;
+    file->cd();
     
-    for(TTree* tree: outputTrees){
+    for(TTree* tree: merged.outputTrees){
         tree->Write();
     }
 
     //End jobs for all analyzers
-    for(unsigned int i = 0; i < analyzers.size(); i++){
-        analyzers[i]->EndJob(file);
+    for(unsigned int i = 0; i < merged.analyzers.size(); i++){
+        merged.analyzers[i]->EndJob(file);
     }
 
-    for(CutFlow& cutflow: cutflows){
-        cutflow.hist->Write();
-        delete cutflow.hist;
+    for(CutFlow& cutflow: merged.cutflows){
+        cutflow.Write();
     }
 
     file->Write();
     file->Close();
 
+    for(SkimWorker& worker: workers){
+        worker.inputFile->Close();
+    }
+
     end = std::chrono::steady_clock::now();
     std::cout << "Finished event loop (in seconds): " << std::chrono::duration_cast<std::chrono::seconds>(end - start).count() << std::endl;
 
     std::cout << "Output file created: " + outFile << std::endl;
+
+    if(performanceReport){
+        merged.monitor.Print(loopTime);
+        merged.monitor.WriteJSON(PerformanceMonitor::ReportName(outFile), loopTime);
+        std::cout << "Performance report created: " + PerformanceMonitor::ReportName(outFile) << std::endl;
+    }
 }
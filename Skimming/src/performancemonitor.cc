@@ -0,0 +1,136 @@
+#include <ChargedSkimming/Skimming/interface/performancemonitor.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include <cxxabi.h>
+
+PerformanceMonitor::PerformanceMonitor(){}
+
+PerformanceMonitor::PerformanceMonitor(const std::vector<std::string> &names):
+    names(names),
+    analyzerTime(names.size(), 0.),
+    nCalls(names.size(), 0),
+    nRejected(names.size(), 0),
+    latency(names.size(), std::vector<Long64_t>(binsPerDecade*nDecades + 2, 0)){}
+
+std::string PerformanceMonitor::TypeName(const std::type_info &type){
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), NULL, NULL, &status);
+
+    std::string name = status == 0 ? demangled : type.name();
+    std::free(demangled);
+
+    return name;
+}
+
+unsigned int PerformanceMonitor::LatencyBin(const double &seconds){
+    if(seconds < minLatency) return 0;
+
+    int bin = 1 + int(std::log10(seconds/minLatency)*binsPerDecade);
+
+    return std::min(bin, binsPerDecade*nDecades + 1);
+}
+
+double PerformanceMonitor::BinEdge(const unsigned int &bin){
+    return minLatency*std::pow(10., double(bin)/binsPerDecade);
+}
+
+double PerformanceMonitor::Quantile(const unsigned int &i, const double &q) const {
+    if(nCalls[i] == 0) return 0.;
+
+    Long64_t sum = 0;
+
+    for(unsigned int bin = 0; bin < latency[i].size(); bin++){
+        sum += latency[i][bin];
+
+        //Upper edge of the bin the quantile falls in
+        if(sum >= q*nCalls[i]) return BinEdge(bin);
+    }
+
+    return BinEdge(latency[i].size() - 1);
+}
+
+void PerformanceMonitor::Merge(const PerformanceMonitor &other){
+    for(unsigned int i = 0; i < names.size(); i++){
+        analyzerTime[i] += other.analyzerTime[i];
+        nCalls[i] += other.nCalls[i];
+        nRejected[i] += other.nRejected[i];
+
+        for(unsigned int bin = 0; bin < latency[i].size(); bin++){
+            latency[i][bin] += other.latency[i][bin];
+        }
+    }
+
+    readTime += other.readTime;
+    fillTime += other.fillTime;
+    nEvents += other.nEvents;
+}
+
+void PerformanceMonitor::Print(const double &wallTime) const {
+    double totalTime = readTime + fillTime;
+    for(const double &time: analyzerTime) totalTime += time;
+
+    std::cout << std::left << std::setw(24) << "Analyzer" << std::right << std::setw(12) << "Time [s]" << std::setw(10) << "Share" << std::setw(14) << "Mean [us]" << std::setw(14) << "p50 [us]" << std::setw(14) << "p99 [us]" << std::setw(12) << "Rejected" << std::endl;
+
+    for(unsigned int i = 0; i < names.size(); i++){
+        std::cout << std::left << std::setw(24) << names[i] << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << analyzerTime[i]
+                  << std::setw(9) << 100*analyzerTime[i]/std::max(totalTime, 1e-9) << "%"
+                  << std::setw(14) << 1e6*analyzerTime[i]/std::max(nCalls[i], Long64_t(1))
+                  << std::setw(14) << 1e6*Quantile(i, 0.5)
+                  << std::setw(14) << 1e6*Quantile(i, 0.99)
+                  << std::setw(11) << 100.*nRejected[i]/std::max(nCalls[i], Long64_t(1)) << "%" << std::endl;
+    }
+
+    std::cout << std::left << std::setw(24) << "Input read" << std::right << std::setw(12) << readTime << std::setw(9) << 100*readTime/std::max(totalTime, 1e-9) << "%" << std::endl;
+    std::cout << std::left << std::setw(24) << "Tree fill" << std::right << std::setw(12) << fillTime << std::setw(9) << 100*fillTime/std::max(totalTime, 1e-9) << "%" << std::endl;
+    std::cout << "Processed " << nEvents << " events in " << wallTime << " s (" << nEvents/std::max(wallTime, 1e-9) << " events/s)" << std::defaultfloat << std::endl;
+}
+
+void PerformanceMonitor::WriteJSON(const std::string &fileName, const double &wallTime) const {
+    std::ofstream file(fileName);
+
+    if(!file.is_open()){
+        std::cout << "Can not write performance report: " << fileName << std::endl;
+        return;
+    }
+
+    file << std::setprecision(9);
+    file << "{\n";
+    file << "  \"events\": " << nEvents << ",\n";
+    file << "  \"wallTime\": " << wallTime << ",\n";
+    file << "  \"eventsPerSecond\": " << nEvents/std::max(wallTime, 1e-9) << ",\n";
+    file << "  \"readTime\": " << readTime << ",\n";
+    file << "  \"fillTime\": " << fillTime << ",\n";
+
+    //Lower bin edges, first bin is underflow starting at 0
+    file << "  \"latencyBinEdges\": [0";
+    for(unsigned int bin = 0; bin < latency.at(0).size() - 1; bin++) file << ", " << BinEdge(bin);
+    file << "],\n";
+
+    file << "  \"analyzers\": [\n";
+
+    for(unsigned int i = 0; i < names.size(); i++){
+        file << "    {\"name\": \"" << names[i] << "\", \"time\": " << analyzerTime[i] << ", \"calls\": " << nCalls[i] << ", \"rejected\": " << nRejected[i];
+        file << ", \"p50\": " << Quantile(i, 0.5) << ", \"p99\": " << Quantile(i, 0.99) << ", \"latency\": [";
+
+        for(unsigned int bin = 0; bin < latency[i].size(); bin++){
+            file << (bin == 0 ? "" : ", ") << latency[i][bin];
+        }
+
+        file << "]}" << (i + 1 < names.size() ? "," : "") << "\n";
+    }
+
+    file << "  ]\n}\n";
+}
+
+std::string PerformanceMonitor::ReportName(const std::string &outFile){
+    std::size_t pos = outFile.rfind(".root");
+
+    return (pos == std::string::npos ? outFile : outFile.substr(0, pos)) + "_performance.json";
+}
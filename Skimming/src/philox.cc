@@ -0,0 +1,54 @@
+#include <ChargedSkimming/Skimming/interface/philox.h>
+
+#include <cmath>
+
+Philox::Philox(){}
+
+Philox::Philox(const unsigned int &run, const unsigned int &lumi, const unsigned long long &event, const unsigned int &stream){
+    key[0] = run;
+    key[1] = stream;
+
+    //First word is the index of the random number
+    counter[1] = lumi;
+    counter[2] = event & 0xFFFFFFFF;
+    counter[3] = event >> 32;
+}
+
+void Philox::Block(std::uint32_t (&values)[4], const std::uint32_t (&key)[2]){
+    std::uint32_t k0 = key[0], k1 = key[1];
+
+    for(int round = 0; round < 10; round++){
+        std::uint64_t product0 = std::uint64_t(0xD2511F53)*values[0];
+        std::uint64_t product1 = std::uint64_t(0xCD9E8D57)*values[2];
+
+        std::uint32_t v0 = (product1 >> 32) ^ values[1] ^ k0;
+        std::uint32_t v2 = (product0 >> 32) ^ values[3] ^ k1;
+
+        values[0] = v0;
+        values[1] = product1;
+        values[2] = v2;
+        values[3] = product0;
+
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+}
+
+float Philox::Gaus(const unsigned int &index) const {
+    std::uint32_t values[4] = {index, counter[1], counter[2], counter[3]};
+    Block(values, key);
+
+    //Box-Muller with uniform numbers in (0, 1] and [0, 1)
+    double u1 = (values[0] + 1.)/4294967296.;
+    double u2 = values[1]/4294967296.;
+
+    return std::sqrt(-2.*std::log(u1))*std::cos(2.*M_PI*u2);
+}
+
+void Philox::Gaus(const unsigned int &n, std::vector<float> &values) const {
+    values.resize(n);
+
+    for(unsigned int i = 0; i < n; i++){
+        values[i] = Gaus(i);
+    }
+}
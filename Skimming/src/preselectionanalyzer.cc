@@ -0,0 +1,46 @@
+#include <ChargedSkimming/Skimming/interface/preselectionanalyzer.h>
+
+PreselectionAnalyzer::PreselectionAnalyzer():
+    BaseAnalyzer(){}
+
+PreselectionAnalyzer::PreselectionAnalyzer(TTreeReader &reader):
+    BaseAnalyzer(&reader){}
+
+void PreselectionAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
+    //Only the counter branches are read, object collections are loaded by the later analyzers
+    if(isNANO){
+        nJet = input->Value<unsigned int>("nJet");
+        nFatJet = input->Value<unsigned int>("nFatJet");
+        nMuon = input->Value<unsigned int>("nMuon");
+        nElectron = input->Value<unsigned int>("nElectron");
+    }
+
+    for(CutFlow& cutflow: cutflows){
+        cutSteps.push_back(cutflow.AddStep("Preselection"));
+    }
+}
+
+void PreselectionAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
+    //Size of the raw collections, with MINIAOD the input collections before any producer ran
+    unsigned int muSize = isNANO ? *nMuon->Get() : context->Muons()->size();
+    unsigned int eleSize = isNANO ? *nElectron->Get() : context->Electrons()->size();
+    unsigned int jetSize = isNANO ? *nJet->Get() : context->Jets()->size();
+    unsigned int fatJetSize = isNANO ? *nFatJet->Get() : context->FatJets()->size();
+
+    //Selected objects are a subset of the raw collections, so too few raw objects can never pass
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        CutFlow& cutflow = cutflows[i];
+
+        if(muSize >= cutflow.nMinMu and eleSize >= cutflow.nMinEle and jetSize >= cutflow.nMinJet and fatJetSize >= cutflow.nMinFatjet){
+            if(cutflow.passed){
+                cutflow.Fill(cutSteps[i]);
+            }
+        }
+
+        else{
+            cutflow.Reject();
+        }
+    }
+}
+
+void PreselectionAnalyzer::EndJob(TFile* file){}
@@ -0,0 +1,51 @@
+#include <ChargedSkimming/Skimming/interface/scalefactortable.h>
+
+#include <stdexcept>
+#include <memory>
+
+#include <TFile.h>
+#include <TH1.h>
+#include <TF1.h>
+
+ScaleFactorTable::ScaleFactorTable():
+    bins({{1., 0.}}){}
+
+ScaleFactorTable::ScaleFactorTable(const std::string &fileName, const std::string &objectName){
+    std::unique_ptr<TFile> file(TFile::Open(fileName.c_str(), "READ"));
+
+    if(file == NULL or file->IsZombie()){
+        throw std::runtime_error("Can not open scale factor file: " + fileName);
+    }
+
+    TObject* object = file->Get(objectName.c_str());
+
+    if(TH1* hist = dynamic_cast<TH1*>(object)){
+        int nBinsX = hist->GetNbinsX();
+        int nBinsY = hist->GetDimension() == 2 ? hist->GetNbinsY() : 1;
+
+        for(int i = 2; i <= nBinsX; i++) xEdges.push_back(hist->GetXaxis()->GetBinLowEdge(i));
+        if(hist->GetDimension() == 2){
+            for(int j = 2; j <= nBinsY; j++) yEdges.push_back(hist->GetYaxis()->GetBinLowEdge(j));
+        }
+
+        nY = nBinsY;
+
+        for(int i = 1; i <= nBinsX; i++){
+            for(int j = 1; j <= nBinsY; j++){
+                if(hist->GetDimension() == 2) bins.push_back({float(hist->GetBinContent(i, j)), float(hist->GetBinError(i, j))});
+                else bins.push_back({float(hist->GetBinContent(i)), float(hist->GetBinError(i))});
+            }
+        }
+    }
+
+    else if(TF1* fileFunction = dynamic_cast<TF1*>(object)){
+        //Clone is not owned by the file, so it survives closing it
+        function.reset((TF1*)fileFunction->Clone());
+    }
+
+    else{
+        throw std::runtime_error("Can not read scale factor '" + objectName + "' from file: " + fileName);
+    }
+
+    file->Close();
+}
@@ -1,13 +1,10 @@
 #include <ChargedAnalysis/Skimming/interface/tauanalyzer.h>
 
-TauAnalyzer::TauAnalyzer(const int &era, const float &ptCut, const float &etaCut, tToken& tauToken, trigObjToken& triggerObjToken, genPartToken& genParticleToken):	//for miniAOD
+TauAnalyzer::TauAnalyzer(const int &era, const float &ptCut, const float &etaCut):	//for miniAOD
     BaseAnalyzer(),    
     era(era),
     ptCut(ptCut),
-    etaCut(etaCut),
-    tauToken(tauToken),
-    triggerObjToken(triggerObjToken),
-    genParticleToken(genParticleToken)
+    etaCut(etaCut)
     {}
 
 TauAnalyzer::TauAnalyzer(const int &era, const float &ptCut, const float &etaCut, TTreeReader& reader):	//for nanoAOD
@@ -18,37 +15,17 @@ TauAnalyzer::TauAnalyzer(const int &era, const float &ptCut, const float &etaCut
     {}
 
 int TauAnalyzer::SetGenParticles(const int &i, const int &pdgID){
+    int index = isNANO ? tauGenIdx->At(i) : -1;
+
+    //Check if gen matched tau comes from h, and if the h comes from H+
+    if(index != -1 and Genealogy().AncestorID(index) == 25){
+        return genealogy->GetOrigin(index) == GenealogyTable::HC_H ? 1 : 2;
+    }
 
- bool isgenMatched = isNANO ? tauGenIdx->At(i) != -1 : false;
-//std::cout << isgenMatched << std::endl;
-
-  if(isgenMatched){
-     int index = 0;
-     index = FirstCopy(tauGenIdx->At(i), pdgID);	//gives the mother index
-
-     int motherID = abs(genID->At(genMotherIdx->At(index)));		//getting motherID from the mother index
-
-     if(motherID == 25){
-         
-         if(isNANO) index = FirstCopy(genMotherIdx->At(index), 25);	
-         else std::cout<<"Not NanoAOD!";
-
-         int motherID = abs(genID->At(genMotherIdx->At(index)));  
-	//std::cout << motherID << std::endl;
-         if(motherID == 37){
-             return 1;
-         }
-
-         else{
-             return 2;
-         }
-     }
-  }
-	
-   return -1.;
+    return -1.;
 }
 
-void TauAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){		
+void TauAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){		
     //SF files
     tauIdSFfiles = {
                     {2017, filePath + "/tauSF/TauID_SF_pt_MVAoldDM2017v2_2017ReReco.root"},
@@ -65,29 +42,24 @@ void TauAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     //Set data bool
     this->isData = isData;
 
-    //Hist with scale factors
-    TFile* tauIdSFfile = TFile::Open(tauIdSFfiles[era].c_str());
-    tauIdSFhist = (TF1*)tauIdSFfile->Get("VLoose_cent");
-
-    TFile* antiMuSFfile = TFile::Open(antiMuSFfiles[era].c_str());
-    antiMuSFhist = (TH1F*)antiMuSFfile->Get("Loose");
-
-    TFile* antiEleSFfile = TFile::Open(antiEleSFfiles[era].c_str());
-    antiEleSFhist = (TH1F*)antiEleSFfile->Get("VLoose");
+    //Scale factors, files are closed after copying the histograms/functions
+    tauIdSF = ScaleFactorTable(tauIdSFfiles[era], "VLoose_cent");
+    antiMuSF = ScaleFactorTable(antiMuSFfiles[era], "Loose");
+    antiEleSF = ScaleFactorTable(antiEleSFfiles[era], "VLoose");
 
 
     //Initiliaze TTreeReaderValues then using NANO AOD
     if(isNANO){
-        tauPt = std::make_unique<TTreeReaderArray<float>>(*reader, "Tau_pt");
-        tauEta = std::make_unique<TTreeReaderArray<float>>(*reader, "Tau_eta");
-        tauPhi = std::make_unique<TTreeReaderArray<float>>(*reader, "Tau_phi");
-        tauCharge = std::make_unique<TTreeReaderArray<int>>(*reader, "Tau_charge");
-        tauAntiEl = std::make_unique<TTreeReaderArray<unsigned char>>(*reader, "Tau_idAntiEle");
-	tauAntiMu = std::make_unique<TTreeReaderArray<unsigned char>>(*reader, "Tau_idAntiMu");
-	tauDM2017new = std::make_unique<TTreeReaderArray<unsigned char>>(*reader, "Tau_idMVAnewDM2017v2");
-	tauDM2017old = std::make_unique<TTreeReaderArray<unsigned char>>(*reader, "Tau_idMVAoldDM2017v2");
-	tauDM = std::make_unique<TTreeReaderArray<int>>(*reader, "Tau_decayMode");
-	tauIdDM = std::make_unique<TTreeReaderArray<bool>>(*reader, "Tau_idDecayMode");
+        tauPt = input->Array<float>("Tau_pt");
+        tauEta = input->Array<float>("Tau_eta");
+        tauPhi = input->Array<float>("Tau_phi");
+        tauCharge = input->Array<int>("Tau_charge");
+        tauAntiEl = input->Array<unsigned char>("Tau_idAntiEle");
+	tauAntiMu = input->Array<unsigned char>("Tau_idAntiMu");
+	tauDM2017new = input->Array<unsigned char>("Tau_idMVAnewDM2017v2");
+	tauDM2017old = input->Array<unsigned char>("Tau_idMVAoldDM2017v2");
+	tauDM = input->Array<int>("Tau_decayMode");
+	tauIdDM = input->Array<bool>("Tau_idDecayMode");
 
 	//Set TTreeReader for genpart and trigger obj from baseanalyzer    
         SetCollection(this->isData);
@@ -116,9 +88,13 @@ void TauAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
             tree->Branch(("Tau_" + intNames[i]).c_str(), &intVariables[i]);
         }
     }
+
+    for(CutFlow &cutflow: cutflows){
+        cutSteps.push_back(cutflow.nMinTau!=0 ? cutflow.AddStep("N_{tau} >= " + std::to_string(cutflow.nMinTau) + " (no iso/ID req)") : 0);
+    }
 }
 
-void TauAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
+void TauAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     //Clear variables vector
     for(std::vector<float>& variable: floatVariables){
         variable.clear();
@@ -138,8 +114,8 @@ void TauAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
 
     //Get Event info if using MINIAOD
     if(!isNANO){
-        event->getByToken(tauToken, taus);
-        event->getByToken(triggerObjToken, trigObjects);
+        taus = context->Taus();
+        trigObjects = context->TriggerObjects();
     }
 
     float tauSize = isNANO ? tauPt->GetSize() : taus->size();
@@ -151,8 +127,7 @@ void TauAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
         float phi = isNANO ? tauPhi->At(i) : 1.;
 
         if(pt > ptCut && abs(eta) < etaCut){
-            TLorentzVector lVec;
-            lVec.SetPtEtaPhiM(pt, eta, phi, 1776.86*1e-3);	
+            FourVector lVec = FourVector::PtEtaPhiM(pt, eta, phi, 1776.86*1e-3);	
 
 	    //Tau four-momentum components
             floatVariables[0].push_back(lVec.E());   //Energy
@@ -177,9 +152,9 @@ void TauAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
 
             if(!isData){
                //Fill scale factors
-                floatVariables[5].push_back(tauIdSFhist->operator()(pt));
-                floatVariables[6].push_back(antiMuSFhist->GetBinContent(antiMuSFhist->FindBin(abs(eta))));
-                floatVariables[7].push_back(antiEleSFhist->GetBinContent(antiEleSFhist->FindBin(abs(eta))));
+                floatVariables[5].push_back(tauIdSF.Get(pt).value);
+                floatVariables[6].push_back(antiMuSF.Get(abs(eta)).value);
+                floatVariables[7].push_back(antiEleSF.Get(abs(eta)).value);
 
                 //Save gen particle information
                 floatVariables[8].push_back(SetGenParticles(i, 15));	
@@ -189,16 +164,17 @@ void TauAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* even
         } 
     }
 
-    for(CutFlow &cutflow: cutflows){			
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        CutFlow &cutflow = cutflows[i];
+
         if(cutflow.nMinTau <= floatVariables[0].size()){
             if(cutflow.nMinTau!=0 and cutflow.passed){
-                std::string cutName("N_{tau} >= " + std::to_string(cutflow.nMinTau) + " (no iso/ID req)");
-                cutflow.hist->Fill(cutName.c_str(), cutflow.weight);
+                cutflow.Fill(cutSteps[i]);
             }
         }
 
         else{
-            cutflow.passed = false;
+            cutflow.Reject();
         }
     }
 }
@@ -5,21 +5,22 @@ TriggerAnalyzer::TriggerAnalyzer(const std::vector<std::string> &muPaths, const
     muPaths(muPaths),
     elePaths(elePaths){}
 
-TriggerAnalyzer::TriggerAnalyzer(const std::vector<std::string> &muPaths, const std::vector<std::string> &elePaths, trigToken& triggerToken):
+TriggerAnalyzer::TriggerAnalyzer(const std::vector<std::string> &muPaths, const std::vector<std::string> &elePaths):
     BaseAnalyzer(),
     muPaths(muPaths),
     elePaths(elePaths),
-    triggerToken(triggerToken){}
+    muIndex(muPaths),
+    eleIndex(elePaths){}
 
-void TriggerAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
+void TriggerAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
     if(isNANO){
         //TTreeReader Values
         for(std::string triggerPath: muPaths){
-            triggerMu.push_back(std::make_unique<TTreeReaderValue<bool>>(*reader, triggerPath.c_str()));
+            triggerMu.push_back(input->Value<bool>(triggerPath));
         }
 
         for(std::string triggerPath: elePaths){
-            triggerEle.push_back(std::make_unique<TTreeReaderValue<bool>>(*reader, triggerPath.c_str()));
+            triggerEle.push_back(input->Value<bool>(triggerPath));
         }
     }
 
@@ -29,82 +30,84 @@ void TriggerAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     for(TTree* tree: trees){
         std::string treeName(tree->GetName());
 
-        if(treeName.find("mu") != std::string::npos){
+        //Single output tree "Events" holds all channels and needs both trigger sets
+        bool allChannels = treeName == "Events";
+
+        if(treeName.find("mu") != std::string::npos or allChannels){
             //Set Branches of output tree
             for(unsigned int i=0; i < muPaths.size(); i++){
                 tree->Branch(muPaths[i].c_str(), &muResults[i]);
             }
         }
 
-        if(treeName.find("e") != std::string::npos){
+        if(treeName.find("e") != std::string::npos or allChannels){
             //Set Branches of output tree
             for(unsigned int i=0; i < elePaths.size(); i++){
                 tree->Branch(elePaths[i].c_str(), &eleResults[i]);
             }
         }
     }
-}
 
-void TriggerAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
-    //Clear result vector
-    eleResults.clear();
-    muResults.clear();
+    //Trigger steps only exist in channels requiring the lepton
+    for(CutFlow& cutflow: cutflows){
+        muSteps.push_back(cutflow.nMinMu>=1 ? cutflow.AddStep(muPaths[0]) : 0);
+        eleSteps.push_back(cutflow.nMinEle>=1 ? cutflow.AddStep(elePaths[0]) : 0);
+    }
+}
 
+void TriggerAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     //Get Event info is using MINIAOD
     edm::Handle<edm::TriggerResults> triggers;
 
     if(!isNANO){
-        event->getByToken(triggerToken, triggers);
-        const edm::TriggerNames &names = event->triggerNames(*triggers);
-
-        for(unsigned int i = 0; i < names.size(); i++){
-            //Find trigger result with given trigger paths with MINIAOD
-            for(std::string& pathName: muPaths){
-                if(names.triggerName(i).find(pathName + "_v") != std::string::npos){
-                    muResults.push_back(triggers->accept(i));
-                }
-            }
+        triggers = context->Triggers();
+        const edm::TriggerNames &names = context->TriggerNames();
 
-            for(std::string& pathName: elePaths){
-                if(names.triggerName(i).find(pathName + "_v") != std::string::npos){
-                    eleResults.push_back(triggers->accept(i));
-                }
-            }
-        }   
+        //Trigger result with given trigger paths with MINIAOD, paths not in the menu did not fire
+        muIndex.Update(names);
+        eleIndex.Update(names);
+
+        for(unsigned int i = 0; i < muPaths.size(); i++){
+            muResults[i] = muIndex.Accept(i, *triggers) == 1;
+        }
+
+        for(unsigned int i = 0; i < elePaths.size(); i++){
+            eleResults[i] = eleIndex.Accept(i, *triggers) == 1;
+        }
     }
 
     else{
         //Trigger result in NANOAOD
-        for(std::unique_ptr<TTreeReaderValue<bool>> &triggerValue: triggerEle){
-            eleResults.push_back(*triggerValue->Get());
+        for(unsigned int i = 0; i < triggerEle.size(); i++){
+            eleResults[i] = *triggerEle[i]->Get();
         }
 
-        for(std::unique_ptr<TTreeReaderValue<bool>> &triggerValue: triggerMu){
-            muResults.push_back(*triggerValue->Get());
+        for(unsigned int i = 0; i < triggerMu.size(); i++){
+            muResults[i] = *triggerMu[i]->Get();
         }
     }
 
-    for(CutFlow& cutflow: cutflows){
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        CutFlow& cutflow = cutflows[i];
+
         if(cutflow.nMinMu>=1){
             if(std::find(muResults.begin(), muResults.end(), 1) != muResults.end()){
                 if(cutflow.passed){
-                    std::string cutName = muPaths[0];
-                    cutflow.hist->Fill(cutName.c_str(), cutflow.weight);                
+                    cutflow.Fill(muSteps[i]);
                 }    
             }
 
-            else cutflow.passed = false;
+            else cutflow.Reject();
         }
 
         if(cutflow.nMinEle>=1){
             if(std::find(eleResults.begin(), eleResults.end(), 1) != eleResults.end()){
                 if(cutflow.passed){
-                    std::string cutName = elePaths[0];
-                    cutflow.hist->Fill(cutName.c_str(), cutflow.weight);        
+                    cutflow.Fill(eleSteps[i]);
                 }
             }
 
-            else cutflow.passed = false;
+            else cutflow.Reject();
         }
     }
 }
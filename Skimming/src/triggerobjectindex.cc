@@ -0,0 +1,103 @@
+#include <ChargedSkimming/Skimming/interface/triggerobjectindex.h>
+#include <ChargedSkimming/Skimming/interface/fourvector.h>
+
+#include <cmath>
+#include <algorithm>
+
+void TriggerObjectIndex::Clear(){
+    isBuilt = false;
+}
+
+bool TriggerObjectIndex::IsBuilt() const {
+    return isBuilt;
+}
+
+TriggerObjectIndex::ObjectType TriggerObjectIndex::TypeFromID(const int &id){
+    switch(std::abs(id)){
+        case 11: case 22: return EGAMMA;
+        case 13: return MUON;
+        case 15: return TAU;
+        case 1: case 6: return JET;
+        default: return OTHER;
+    }
+}
+
+void TriggerObjectIndex::Add(const ObjectType &type, const float &pt, const float &eta, const float &phi, const std::uint32_t &bits){
+    inputTypes.push_back(type);
+    inputP4.push_back({pt, eta, phi});
+    inputBits.push_back(bits);
+}
+
+void TriggerObjectIndex::Build(const ColumnView<int> &id, const ColumnView<float> &pt, const ColumnView<float> &eta, const ColumnView<float> &phi, const ColumnView<int> &bits){
+    for(unsigned int i = 0; i < id.GetSize(); i++){
+        Add(TypeFromID(id.At(i)), pt.At(i), eta.At(i), phi.At(i), bits.At(i));
+    }
+
+    Partition();
+}
+
+void TriggerObjectIndex::Build(const std::vector<pat::TriggerObjectStandAlone> &trigObj){
+    for(const pat::TriggerObjectStandAlone &obj: trigObj){
+        ObjectType type = OTHER;
+
+        if(obj.hasTriggerObjectType(trigger::TriggerElectron) or obj.hasTriggerObjectType(trigger::TriggerPhoton)) type = EGAMMA;
+        else if(obj.hasTriggerObjectType(trigger::TriggerMuon)) type = MUON;
+        else if(obj.hasTriggerObjectType(trigger::TriggerTau)) type = TAU;
+        else if(obj.hasTriggerObjectType(trigger::TriggerJet) or obj.hasTriggerObjectType(trigger::TriggerBJet)) type = JET;
+
+        Add(type, obj.pt(), obj.eta(), obj.phi(), 0);
+    }
+
+    Partition();
+}
+
+void TriggerObjectIndex::Partition(){
+    //Counting sort by type, keeps the original order within a type
+    typeStart.fill(0);
+
+    for(const unsigned char &type: inputTypes) typeStart[type + 1]++;
+    for(unsigned int t = 0; t < NTYPES; t++) typeStart[t + 1] += typeStart[t];
+
+    std::array<unsigned int, NTYPES + 1> position = typeStart;
+
+    pts.resize(inputTypes.size());
+    etas.resize(inputTypes.size());
+    phis.resize(inputTypes.size());
+    filterBits.resize(inputTypes.size());
+
+    for(unsigned int i = 0; i < inputTypes.size(); i++){
+        unsigned int k = position[inputTypes[i]]++;
+
+        pts[k] = inputP4[i][0];
+        etas[k] = inputP4[i][1];
+        phis[k] = inputP4[i][2];
+        filterBits[k] = inputBits[i];
+    }
+
+    inputTypes.clear();
+    inputP4.clear();
+    inputBits.clear();
+
+    isBuilt = true;
+}
+
+bool TriggerObjectIndex::Match(const ObjectType &type, const float &pt, const float &eta, const float &phi, const float &maxDeltaR, const float &maxRelPt, const std::uint32_t &filterMask) const {
+    const float maxDeltaR2 = maxDeltaR*maxDeltaR, maxDeltaPt = maxRelPt*pt;
+    unsigned int nMatched = 0;
+
+    //Scan over the contiguous objects of this type, matches are counted without branching
+    const unsigned int first = typeStart[type], last = typeStart[type + 1];
+    const float* objPt = pts.data();
+    const float* objEta = etas.data();
+    const float* objPhi = phis.data();
+    const std::uint32_t* objBits = filterBits.data();
+
+    for(unsigned int i = first; i < last; i++){
+        float dEta = objEta[i] - eta;
+        float dPhi = FourVector::DeltaPhi(objPhi[i], phi);
+
+        nMatched += int(dEta*dEta + dPhi*dPhi < maxDeltaR2) & int(std::abs(pt - objPt[i]) < maxDeltaPt) & int((objBits[i] & filterMask) == filterMask);
+    }
+
+    return nMatched != 0;
+}
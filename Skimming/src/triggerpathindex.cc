@@ -0,0 +1,41 @@
+#include <ChargedSkimming/Skimming/interface/triggerpathindex.h>
+
+#include <cctype>
+
+TriggerPathIndex::TriggerPathIndex(const std::vector<std::string> &paths):
+    paths(paths),
+    pathIndex(paths.size(), -1){}
+
+bool TriggerPathIndex::IsVersionOf(const std::string &name, const std::string &path){
+    if(name.compare(0, path.size(), path) != 0) return false;
+    if(name.size() == path.size()) return true;
+
+    //Only a version suffix "_v<number>" may follow
+    if(name.size() < path.size() + 3 or name.compare(path.size(), 2, "_v") != 0) return false;
+
+    for(unsigned int i = path.size() + 2; i < name.size(); i++){
+        if(!std::isdigit(name[i])) return false;
+    }
+
+    return true;
+}
+
+void TriggerPathIndex::Update(const edm::TriggerNames &names){
+    if(isResolved and names.parameterSetID() == menuID) return;
+
+    //Last version in the menu is taken if there are several
+    pathIndex.assign(paths.size(), -1);
+
+    for(unsigned int i = 0; i < names.size(); i++){
+        for(unsigned int j = 0; j < paths.size(); j++){
+            if(IsVersionOf(names.triggerName(i), paths[j])) pathIndex[j] = i;
+        }
+    }
+
+    menuID = names.parameterSetID();
+    isResolved = true;
+}
+
+int TriggerPathIndex::Accept(const unsigned int &i, const edm::TriggerResults &results) const {
+    return pathIndex[i] != -1 ? results.accept(pathIndex[i]) : -1;
+}
@@ -6,16 +6,14 @@ WeightAnalyzer::WeightAnalyzer(const float era, const float xSec, TTreeReader &r
     xSec(xSec)
     {}
 
-WeightAnalyzer::WeightAnalyzer(const float era, const float xSec, puToken &pileupToken, genToken &geninfoToken):
+WeightAnalyzer::WeightAnalyzer(const float era, const float xSec):
     BaseAnalyzer(),
     era(era),
-    xSec(xSec),
-    pileupToken(pileupToken),
-    geninfoToken(geninfoToken)
+    xSec(xSec)
     {}
 
 
-void WeightAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
+void WeightAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData, std::vector<CutFlow> &cutflows){
     //Set lumi map
     lumis = {{2016, 35.92*1e3}, {2017, 41.53*1e3}};
 
@@ -25,16 +23,21 @@ void WeightAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
     if(!this->isData){
         if(isNANO){
             //Initiliaze TTreeReaderValues
-            genWeightValue = std::make_unique<TTreeReaderValue<float>>(*reader, "Generator_weight");
-            nPU = std::make_unique<TTreeReaderValue<float>>(*reader, "Pileup_nTrueInt");
+            genWeightValue = input->Value<float>("Generator_weight");
+            nPU = input->Value<float>("Pileup_nTrueInt");
         }        
 
         puMC = new TH1F("puMC", "puMC", 100, 0, 100);
         nGenHist = new TH1F("nGen", "nGen", 100, 0, 2);
         nGenWeightedHist = new TH1F("nGenWeighted", "nGenWeighted", 100, -1e7, 1e7);
+
+        //Keep histograms out of gDirectory, each skimming thread owns its own copy
+        for(TH1F* hist: {puMC, nGenHist, nGenWeightedHist}){
+            hist->SetDirectory(NULL);
+        }
     }
 
-    evtNumber = std::make_unique<TTreeReaderValue<ULong64_t>>(*reader, "event");
+    evtNumber = input->Value<ULong64_t>("event");
 
     //Branches for output tree
     for(TTree* tree: trees){
@@ -44,15 +47,19 @@ void WeightAnalyzer::BeginJob(std::vector<TTree*>& trees, bool &isData){
         tree->Branch("Misc_TrueInteraction", &nTrueInt);
         tree->Branch("Misc_eventNumber", &eventNumber);
     }
+
+    for(CutFlow& cutflow: cutflows){
+        cutSteps.push_back(cutflow.AddStep("No cuts"));
+    }
 }
 
-void WeightAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* event){
+void WeightAnalyzer::Analyze(std::vector<CutFlow> &cutflows, EventContext* context){
     edm::Handle<std::vector<PileupSummaryInfo>> pileUp; 
     edm::Handle<GenEventInfoProduct> genInfo;
     
-    if(!isNANO){
-        event->getByToken(pileupToken, pileUp);
-        event->getByToken(geninfoToken, genInfo);
+    if(!isNANO and !isData){
+        pileUp = context->PileUp();
+        genInfo = context->GenInfo();
     }
 
     //Set values if not data
@@ -66,12 +73,22 @@ void WeightAnalyzer::Analyze(std::vector<CutFlow> &cutflows, const edm::Event* e
         puMC->Fill(nTrueInt);
     }
 
-    eventNumber = isNANO ? *evtNumber->Get() : event->eventAuxiliary().id().event();
+    eventNumber = isNANO ? *evtNumber->Get() : context->EventNumber();
 
-    for(CutFlow& cutflow: cutflows){
-        cutflow.weight = xSec*lumi;
-        cutflow.hist->Fill("No cuts", cutflow.weight);
-        cutflow.passed *= true;
+    for(unsigned int i = 0; i < cutflows.size(); i++){
+        cutflows[i].weight = xSec*lumi;
+        cutflows[i].Fill(cutSteps[i]);
+        cutflows[i].passed *= true;
+    }
+}
+
+void WeightAnalyzer::Merge(const std::shared_ptr<BaseAnalyzer>& other){
+    std::shared_ptr<WeightAnalyzer> otherWeight = std::static_pointer_cast<WeightAnalyzer>(other);
+
+    if(!this->isData){
+        puMC->Add(otherWeight->puMC);
+        nGenHist->Add(otherWeight->nGenHist);
+        nGenWeightedHist->Add(otherWeight->nGenWeightedHist);
     }
 }
 